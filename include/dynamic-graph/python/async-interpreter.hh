@@ -0,0 +1,84 @@
+// -*- mode: c++ -*-
+// Copyright 2026, CNRS.
+
+#ifndef DYNAMIC_GRAPH_PYTHON_ASYNC_INTERPRETER_HH
+#define DYNAMIC_GRAPH_PYTHON_ASYNC_INTERPRETER_HH
+
+#include "dynamic-graph/python/interpreter.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace dynamicgraph {
+namespace python {
+///
+/// This class executes python commands in a dedicated thread.
+///
+/// Commands are pushed into a lock-free queue and executed in order by a
+/// thread that owns the GIL while it runs them. Submitting a command never
+/// takes the GIL, nor any lock, so that it does not wait for the interpreter
+/// thread nor for the commands being executed. It is not free of system calls
+/// though: it allocates a node of the queue, copies the command and the
+/// callback, and notifies the interpreter thread. The overload returning a
+/// future also allocates the promise.
+///
+/// While an AsyncInterpreter exists, the Interpreter it wraps must not be
+/// used directly by other threads.
+class DYNAMIC_GRAPH_PYTHON_DLLAPI AsyncInterpreter {
+ public:
+  /// Function called, in the interpreter thread, once a command is executed.
+  typedef std::function<void(const CommandResult&)> Callback_t;
+
+  /// \param interpreter the interpreter executing the commands.
+  AsyncInterpreter(Interpreter& interpreter);
+  /// \brief Execute the pending commands and stop the thread.
+  ~AsyncInterpreter();
+
+  /// \brief Submit a command.
+  /// \return a future holding the result, stdout and stderr strings.
+  std::future<CommandResult> submit(const std::string& command);
+
+  /// \brief Submit a command.
+  /// \param callback called in the interpreter thread with the result,
+  ///        stdout and stderr strings.
+  void submit(const std::string& command, const Callback_t& callback);
+
+  /// \brief Submit a command whose result is ignored.
+  void post(const std::string& command);
+
+ private:
+  struct Node {
+    std::atomic<Node*> next;
+    std::string command;
+    Callback_t callback;
+  };
+
+  /// Multiple producers, single consumer intrusive queue (D. Vyukov).
+  void push(Node* node);
+  /// \return the oldest node or NULL if the queue is empty.
+  Node* pop();
+  /// The loop of the interpreter thread.
+  void run();
+
+  Interpreter& interpreter_;
+
+  /// The most recently pushed node.
+  std::atomic<Node*> head_;
+  /// The oldest node, only accessed by the interpreter thread.
+  Node* tail_;
+  Node stub_;
+
+  std::atomic<bool> stop_;
+  /// Used to wake up the interpreter thread when the queue is empty.
+  std::mutex mutex_;
+  std::condition_variable wakeUp_;
+  std::thread thread_;
+};
+}  // namespace python
+}  // namespace dynamicgraph
+#endif  // DYNAMIC_GRAPH_PYTHON_ASYNC_INTERPRETER_HH
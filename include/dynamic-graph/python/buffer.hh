@@ -0,0 +1,98 @@
+// -*- mode: c++ -*-
+// Copyright 2026, CNRS.
+
+#ifndef DYNAMIC_GRAPH_PYTHON_BUFFER_HH
+#define DYNAMIC_GRAPH_PYTHON_BUFFER_HH
+
+#include <dynamic-graph/linear-algebra.h>
+
+#include "dynamic-graph/python/api.hh"
+#include "dynamic-graph/python/python-compat.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+/// \brief Access to the memory of a Python object exposing a buffer of
+///        double, such as a float64 numpy array, without copy.
+///
+/// Objects of dimension 0, 1 and 2 are supported. One-dimensional buffers are
+/// seen as column vectors. The Python buffer is held as long as this object
+/// exists, which must be with the GIL held.
+class DYNAMIC_GRAPH_PYTHON_DLLAPI Buffer {
+ public:
+  typedef Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic> Stride_t;
+  typedef Eigen::Map<Matrix, Eigen::Unaligned, Stride_t> Map_t;
+
+  /// \param o the Python object
+  /// \param writable whether write access to the memory is required.
+  Buffer(PyObject* o, bool writable = false);
+  ~Buffer();
+
+  /// Whether the object exposes a buffer of double of dimension at most 2.
+  bool valid() const { return valid_; }
+  int ndim() const { return view_.ndim; }
+  Eigen::Index rows() const { return rows_; }
+  Eigen::Index cols() const { return cols_; }
+  Eigen::Index size() const { return rows_ * cols_; }
+
+  /// The memory seen as a column-major matrix. Only valid if valid() is true.
+  Map_t map() const {
+    return Map_t(static_cast<double*>(view_.buf), rows_, cols_, Stride_t(outerStride_, innerStride_));
+  }
+
+ private:
+  Buffer(const Buffer&);
+  Buffer& operator=(const Buffer&);
+
+  Py_buffer view_;
+  bool acquired_, valid_;
+  Eigen::Index rows_, cols_, innerStride_, outerStride_;
+};
+
+/// \brief Memory layout of an array of double.
+struct DYNAMIC_GRAPH_PYTHON_DLLAPI ArrayLayout {
+  double* data;
+  /// 0, 1 or 2
+  int ndim;
+  Py_ssize_t shape[2];
+  /// Strides in bytes
+  Py_ssize_t strides[2];
+
+  Py_ssize_t size() const { return (ndim > 0 ? shape[0] : 1) * (ndim > 1 ? shape[1] : 1); }
+  bool sameShape(const ArrayLayout& other) const {
+    return ndim == other.ndim && (ndim < 1 || shape[0] == other.shape[0]) && (ndim < 2 || shape[1] == other.shape[1]);
+  }
+  /// The memory seen as a column-major matrix, as Buffer::map.
+  Buffer::Map_t map() const {
+    const Py_ssize_t itemsize = sizeof(double);
+    const Eigen::Index rows = (ndim > 0 ? shape[0] : 1), cols = (ndim > 1 ? shape[1] : 1);
+    const Eigen::Index inner = (ndim > 0 ? strides[0] / itemsize : 1);
+    const Eigen::Index outer = (ndim > 1 ? strides[1] / itemsize : rows * inner);
+    return Buffer::Map_t(data, rows, cols, Buffer::Stride_t(outer, inner));
+  }
+  /// Copy the elements, in row-major order, into dst of size size().
+  void copyTo(double* dst) const;
+  /// Copy the elements, in row-major order, from src of size size().
+  void copyFrom(const double* src) const;
+};
+
+/// Whether buffer is valid and has the dimension and shape described by layout.
+DYNAMIC_GRAPH_PYTHON_DLLAPI bool sameShape(const Buffer& buffer, const ArrayLayout& layout);
+
+/// \brief Copy the elements of buffer into the memory described by layout,
+///        of the same shape. The memory may overlap.
+DYNAMIC_GRAPH_PYTHON_DLLAPI void copyArray(const Buffer& buffer, const ArrayLayout& layout);
+
+/// \brief Return a new reference to a numpy array using the memory described
+///        by layout, or NULL with a Python error set.
+///
+/// The array does not own the memory, which must remain valid as long as the
+/// array is used. Must be called with the GIL held.
+/// \param writable whether the array can be modified.
+/// \param owner object kept alive by the array, may be NULL.
+DYNAMIC_GRAPH_PYTHON_DLLAPI PyObject* arrayView(const ArrayLayout& layout, bool writable, PyObject* owner);
+
+}  // namespace python
+}  // namespace dynamicgraph
+
+#endif  // DYNAMIC_GRAPH_PYTHON_BUFFER_HH
@@ -10,6 +10,23 @@ namespace python {
 namespace convert {
 
 command::Value toValue(boost::python::object o, const command::Value::Type& type);
+
+/// \brief A function converting a Python object into a Value of a given type.
+typedef command::Value (*ValueConverter)(PyObject* o);
+/// \brief Return the function converting Python objects into Values of type type.
+///
+/// Python scalars are converted with the Python C API, other objects as by
+/// toValue(o, type), which also reports the conversion errors.
+ValueConverter valueConverter(const command::Value::Type& type);
+/// \brief Convert a Python object into a Value whose type is inferred from
+///        the Python type.
+///
+/// None, bool, int, float and str are mapped to the corresponding scalar
+/// types. Integers out of the range of int are mapped to UNSIGNED, or to
+/// DOUBLE if they are not in its range either. Objects exposing a buffer of double of dimension 1 or 2 (e.g. numpy
+/// arrays) are mapped to VECTOR or MATRIX and lists or tuples to VALUES.
+/// \throw std::invalid_argument if the type cannot be inferred.
+command::Value toValue(boost::python::object o);
 boost::python::object fromValue(const command::Value& value);
 
 }  // namespace convert
@@ -7,6 +7,7 @@
 #include <boost/python.hpp>
 #include <boost/python/stl_iterator.hpp>
 
+#include <dynamic-graph/command.h>
 #include <dynamic-graph/debug.h>
 #include <dynamic-graph/exception-factory.h>
 #include <dynamic-graph/signal-base.h>
@@ -36,12 +37,29 @@ inline std::vector<T> to_std_vector(const bp::object& iterable) {
   return std::vector<T>(bp::stl_input_iterator<T>(iterable), bp::stl_input_iterator<T>());
 }
 
+struct ArrayLayout;
+
 void exposeSignals();
 
 // Declare functions defined in other source files
 namespace signalBase {
-SignalBase<int>* createSignalWrapper(const char* name, const char* type, bp::object object);
+void registerSignalWrapperTypes();
+SignalBase<int>* createSignalWrapper(const char* name, const char* type, bp::object object, bool outParameter,
+                                     bool asynchronous, bp::object user);
+bp::list getSignalWrapperTypes();
 }  // namespace signalBase
+namespace signalExpression {
+void expose();
+}  // namespace signalExpression
+namespace signalGroup {
+void expose();
+bp::object recomputeRange(SignalBase<int>& signal, int t0, int t1, int step, bp::object others);
+/// The shape of the arrays described by layout, as a tuple.
+bp::tuple shape(const ArrayLayout& layout);
+}  // namespace signalGroup
+namespace signalHistory {
+void expose();
+}  // namespace signalHistory
 namespace entity {
 
 /// \param obj an Entity object
@@ -50,6 +68,21 @@ void addSignals(boost::python::object obj);
 
 Entity* create(const char* type, const char* name);
 bp::object executeCmd(bp::tuple args, bp::dict);
+/// \brief Execute commands given as (entity name, command name, arguments).
+///
+/// All the commands are found and their arguments converted before the first
+/// one is executed. The GIL is released while executing the commands marked
+/// thread-safe: other Python threads may then run, and must not call these
+/// commands, nor modify their entities, until the batch returns.
+/// \return the list of the results, None for the commands which failed, and
+///         the list of (index, error message) of the commands which failed.
+bp::tuple executeBatch(bp::object entries);
+/// \brief Whether the command may be executed without the GIL by executeBatch.
+///
+/// The flag is shared by the commands of the same name of all the entities of
+/// the class of the owner of the command.
+bool isThreadSafe(command::Command& command);
+void setThreadSafe(command::Command& command, bool threadSafe);
 }  // namespace entity
 
 namespace factory {
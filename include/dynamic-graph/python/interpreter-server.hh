@@ -0,0 +1,101 @@
+// -*- mode: c++ -*-
+// Copyright 2026, CNRS.
+
+#ifndef DYNAMIC_GRAPH_PYTHON_INTERPRETER_SERVER_HH
+#define DYNAMIC_GRAPH_PYTHON_INTERPRETER_SERVER_HH
+
+#include "dynamic-graph/python/interpreter.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dynamicgraph {
+namespace python {
+///
+/// This class serves an interpreter on local sockets.
+///
+/// The server listens on a Unix domain socket and, optionally, on a loopback
+/// TCP port. Clients send commands as frames made of the length of the
+/// command, as a 32 bits big-endian unsigned integer, followed by the command.
+///
+/// For each command, in order, the server replies with frames made of a type
+/// byte, the length of the payload as a 32 bits big-endian unsigned integer,
+/// and the payload: a STDOUT frame and a STDERR frame if the command wrote
+/// anything, then always a RESULT frame, which ends the reply.
+///
+/// Clients may send many commands without waiting for the replies. The
+/// commands received at once, from all the clients, are executed under a
+/// single acquisition of the GIL.
+///
+/// While an InterpreterServer exists, the Interpreter it wraps must not be
+/// used directly by other threads.
+///
+/// \warning There is no authentication: any local user able to connect
+/// executes arbitrary Python code with the rights of the process. The Unix
+/// socket is protected by the permissions of its file and directory, but the
+/// TCP port is open to all the local users. It is therefore disabled by
+/// default.
+class DYNAMIC_GRAPH_PYTHON_DLLAPI InterpreterServer {
+ public:
+  /// The type byte of the reply frames.
+  enum FrameType { RESULT = 'r', STDOUT = 'o', STDERR = 'e' };
+  /// Connections sending larger frames are closed.
+  static const std::uint32_t maxFrameSize = 1u << 26;
+
+  /// \brief Start serving the interpreter in a dedicated thread.
+  /// \param socketPath path of the Unix domain socket. An existing socket at
+  ///        this path is removed.
+  /// \param tcpPort port listened on 127.0.0.1. 0 picks a free port, a
+  ///        negative value, the default, disables TCP. Any local user
+  ///        connecting to this port may execute arbitrary Python code, as
+  ///        there is no authentication.
+  /// \throw std::runtime_error if a socket cannot be created, or if a file
+  ///        which is not a socket exists at socketPath.
+  InterpreterServer(Interpreter& interpreter, const std::string& socketPath, int tcpPort = -1);
+  /// \brief Close the connections, remove the socket file and stop the thread.
+  ~InterpreterServer();
+
+  const std::string& socketPath() const { return socketPath_; }
+  /// \brief The TCP port listened on, or -1.
+  int tcpPort() const { return tcpPort_; }
+
+ private:
+  struct Connection {
+    int fd;
+    /// Received bytes not forming a complete frame yet.
+    std::string input;
+    /// Reply frames not sent yet, from outputOffset.
+    std::string output;
+    std::size_t outputOffset;
+    /// Whether the client will not send anything anymore.
+    bool eof;
+    /// Whether the connection must be closed.
+    bool closed;
+  };
+
+  void closeSockets();
+  /// The loop of the server thread.
+  void run();
+  void accept(int listenFd);
+  /// Read the available bytes and extract the complete command frames.
+  void receive(Connection& connection, std::vector<std::string>& commands);
+  /// Send as much of the pending output as possible without blocking.
+  void send(Connection& connection);
+
+  Interpreter& interpreter_;
+  std::string socketPath_;
+  int tcpPort_;
+  int unixFd_;
+  int tcpFd_;
+  /// Pipe used to wake up the server thread when stopping.
+  int wakeUp_[2];
+  std::vector<Connection> connections_;
+  std::atomic<bool> stop_;
+  std::thread thread_;
+};
+}  // namespace python
+}  // namespace dynamicgraph
+#endif  // DYNAMIC_GRAPH_PYTHON_INTERPRETER_SERVER_HH
@@ -11,18 +11,48 @@
 
 #include "dynamic-graph/python/python-compat.hh"
 #include "dynamic-graph/python/api.hh"
+#include "dynamic-graph/python/latency-stats.hh"
+
+#include <iosfwd>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dynamic-graph/linear-algebra.h>
+#include <dynamic-graph/value.h>
 
 namespace dynamicgraph {
 namespace python {
+/// \brief Result, standard output and standard error of a command.
+struct CommandResult {
+  std::string result;
+  std::string out;
+  std::string err;
+};
+
 ///
 /// This class implements a basis python interpreter.
 ///
 /// String sent to method python are interpreted by an onboard python
 /// interpreter.
+///
+/// The interpreter is created and destroyed by the same thread. The other
+/// methods may be called from any thread: they take the GIL with the Python
+/// thread state of the calling thread, so that the commands may themselves
+/// take the GIL with PyGILState_Ensure.
 class DYNAMIC_GRAPH_PYTHON_DLLAPI Interpreter {
  public:
   Interpreter();
   ~Interpreter();
+
+  /// \brief Restore the global variables to their state after construction.
+  ///
+  /// Variables defined since then are removed and modified ones are restored.
+  /// Imported modules remain in sys.modules. This is a cheap alternative to
+  /// destroying and re-creating the interpreter.
+  void reset();
+
   /// \brief Method to start python interperter.
   /// \param command string to execute
   /// Method deprecated, you *SHOULD* handle error messages.
@@ -32,27 +62,176 @@ class DYNAMIC_GRAPH_PYTHON_DLLAPI Interpreter {
   /// \param command string to execute, result, stdout, stderr strings
   void python(const std::string& command, std::string& result, std::string& out, std::string& err);
 
+  /// \brief Execute a sequence of commands under a single acquisition of the GIL.
+  /// \param commands the commands to execute, in order.
+  /// \retval results the result, stdout and stderr strings of each executed
+  ///         command.
+  /// \param stopOnError whether to stop after the first command that fails.
+  /// \return the number of executed commands.
+  std::size_t python(const std::vector<std::string>& commands, std::vector<CommandResult>& results,
+                     bool stopOnError = false);
+
+  /// \brief Execute a command and convert its result into a Value.
+  ///
+  /// The type of the value is inferred from the type of the Python result,
+  /// see convert::toValue. This avoids the conversion of the result into a
+  /// string.
+  /// \param command string to execute, result, stdout, stderr strings
+  void python(const std::string& command, command::Value& result, std::string& out, std::string& err);
+
+  /// \brief Execute a command and copy its result into a matrix or a vector.
+  ///
+  /// The result must be a float or an object exposing a buffer of double
+  /// (e.g. a float64 numpy array) of the size of result. The data is copied
+  /// directly, without formatting nor allocation.
+  /// \param command string to execute, result, stdout, stderr strings
+  /// \return whether the result could be copied. If not, err is filled.
+  bool python(const std::string& command, Eigen::Ref<Matrix> result, std::string& out, std::string& err);
+
   /// \brief Method to exectue a python script.
   /// \param filename the filename
   void runPythonFile(std::string filename);
   void runPythonFile(std::string filename, std::string& err);
+
+  /// \brief Set the directory where the scripts run by runPythonFile are cached.
+  ///
+  /// Scripts are compiled once and their code objects are stored in this
+  /// directory, keyed by path, modification time, size and Python version.
+  /// As long as a script is not modified, it is loaded from the cache instead
+  /// of being parsed and compiled again.
+  /// \param directory an existing directory. An empty string, the default,
+  ///        disables the cache.
+  void setBytecodeCacheDirectory(const std::string& directory);
+  const std::string& bytecodeCacheDirectory() const { return bytecodeCacheDirectory_; }
+  /// \brief The file caching the code object of a script, an empty string if
+  ///        the cache is disabled.
+  std::string bytecodeCacheFile(const std::string& filename) const;
+  /// \brief Number of scripts loaded from the bytecode cache.
+  std::size_t bytecodeCacheHits() const { return bytecodeCacheHits_; }
+  /// \brief Number of scripts compiled as they were not found in the bytecode cache.
+  std::size_t bytecodeCacheMisses() const { return bytecodeCacheMisses_; }
   void runMain(void);
 
   /// \brief Process input stream to send relevant blocks to python
   /// \param stream input stream
+  /// \return the content of the stream up to the next ';'.
   std::string processStream(std::istream& stream, std::ostream& os);
 
+  /// \brief Execute the Python code read from a stream.
+  ///
+  /// The stream is read line by line, without any limit on the size of the
+  /// input. Lines are grouped into complete top-level statements, as detected
+  /// by codeop.compile_command. When no more input is immediately available,
+  /// a complete simple statement is executed at once, while a compound
+  /// statement waits for the next top-level statement or the end of the
+  /// stream, as more lines may continue it. Statements available at once are
+  /// executed under a single acquisition of the GIL.
+  /// \param stream input stream
+  /// \param os stream on which the outputs and errors are written.
+  /// \return the number of statements that raised an error.
+  std::size_t runStream(std::istream& stream, std::ostream& os);
+
   /// \brief Return a pointer to the dictionary of global variables
   PyObject* globals();
 
+  /// \brief Set the maximal number of compiled commands kept in the code cache.
+  ///
+  /// Commands sent to method python are compiled once and the resulting code
+  /// objects are kept in a least-recently-used cache keyed by the command text.
+  /// \param size maximal number of entries. 0 disables the cache.
+  void setCodeCacheSize(std::size_t size);
+  /// \brief Maximal number of compiled commands kept in the code cache.
+  std::size_t codeCacheSize() const { return codeCacheCapacity_; }
+  /// \brief Number of commands found in the code cache.
+  std::size_t codeCacheHits() const { return codeCacheHits_; }
+  /// \brief Number of commands that had to be compiled.
+  std::size_t codeCacheMisses() const { return codeCacheMisses_; }
+  /// \brief Remove all the entries of the code cache and reset the counters.
+  void clearCodeCache();
+
+  /// \brief Enable or disable the recording of the latencies of the commands.
+  ///
+  /// When enabled, the duration of each phase of the commands sent to method
+  /// python is recorded, as well as the total duration of each distinct
+  /// command. The statistics are also available from Python in module
+  /// interpreter_latency. Disabled by default.
+  void enableLatencyStats(bool enable = true) { latencyStats_->enabled.store(enable); }
+  bool latencyStatsEnabled() const { return latencyStats_->enabled.load(); }
+  /// \brief Copy of the latencies recorded since the last reset.
+  /// Can be called from any thread.
+  LatencyStats latencyStats();
+  /// \brief Clear the recorded latencies. Can be called from any thread.
+  void resetLatencyStats();
+
  private:
+  /// Measure the durations of the phases of a command.
+  class PhaseTimer;
+
+  /// A command compiled either as an expression or as a statement.
+  struct CompiledCommand {
+    std::string command;
+    /// The code object (owned reference)
+    PyObject* code;
+    /// Py_eval_input or Py_single_input
+    int mode;
+  };
+  typedef std::list<CompiledCommand> CodeCache_t;
+
+  /// \brief Execute a command. Must be called with the GIL held.
+  /// \return a new reference to the result or NULL if an error occured.
+  PyObject* run(const std::string& command, std::string& out, std::string& err, PhaseTimer& timer);
+  /// \brief Return a new reference to the code object of the command.
+  /// Must be called with the GIL held.
+  /// \return NULL if the command cannot be compiled. err is then filled.
+  PyObject* compile(const std::string& command, int& mode, std::string& err, PhaseTimer& timer);
+  /// Restore the global variables from the snapshot. Must be called with the GIL held.
+  void restoreGlobals();
+  /// \brief Execute blocks of code read by runStream.
+  /// \param incomplete code of the previous blocks that needs more input.
+  /// \param last whether there is no more input after blocks.
+  /// \param open whether the next lines may continue the last block. It is
+  ///        then kept in incomplete if it is a compound statement.
+  std::size_t runBlocks(const std::vector<std::string>& blocks, std::string& incomplete, bool last, bool open,
+                        std::ostream& os);
+  /// \brief Return a new reference to the code object of a script, either
+  ///        loaded from the bytecode cache or compiled from source.
+  /// Must be called with the GIL held.
+  PyObject* compileFile(const std::string& filename, const std::string& source);
+  /// \brief Load a code object from the bytecode cache.
+  /// \return NULL if the cache file does not exist or does not start with header.
+  PyObject* loadBytecode(const std::string& cacheFile, const std::string& header);
+  void saveBytecode(const std::string& cacheFile, const std::string& header, PyObject* code);
+  /// Remove the least recently used entries until the size fits the capacity.
+  /// Must be called with the GIL held.
+  void shrinkCodeCache(std::size_t capacity);
+
   /// The Python thread state
   PyThreadState* _pyState;
   /// Pointer to the dictionary of global variables
   PyObject* globals_;
   /// Pointer to the dictionary of local variables
   PyObject* locals_;
+  /// Copy of the dictionary of global variables after initialization
+  PyObject* globalsSnapshot_;
   PyObject* mainmod_;
+  /// The objects replacing sys.stdout and sys.stderr
+  PyObject* stdoutCatcher_;
+  PyObject* stderrCatcher_;
+
+  /// Compiled commands, the most recently used first.
+  CodeCache_t codeCache_;
+  std::unordered_map<std::string, CodeCache_t::iterator> codeCacheIndex_;
+  std::size_t codeCacheCapacity_;
+  std::size_t codeCacheHits_;
+  std::size_t codeCacheMisses_;
+
+  std::string bytecodeCacheDirectory_;
+  std::size_t bytecodeCacheHits_;
+  std::size_t bytecodeCacheMisses_;
+
+  /// Owned by latencyStatsCapsule_, shared with module interpreter_latency.
+  LatencyStats* latencyStats_;
+  PyObject* latencyStatsCapsule_;
 };
 }  // namespace python
 }  // namespace dynamicgraph
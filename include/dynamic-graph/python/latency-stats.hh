@@ -0,0 +1,93 @@
+// -*- mode: c++ -*-
+// Copyright 2026, CNRS.
+
+#ifndef DYNAMIC_GRAPH_PYTHON_LATENCY_STATS_HH
+#define DYNAMIC_GRAPH_PYTHON_LATENCY_STATS_HH
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "dynamic-graph/python/api.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+/// \brief Histogram of durations with logarithmic buckets.
+///
+/// Each power of two is divided into 4 buckets, so that quantiles are
+/// estimated within 25%, for durations from 1ns to about 8 minutes.
+class DYNAMIC_GRAPH_PYTHON_DLLAPI LatencyHistogram {
+ public:
+  typedef std::chrono::nanoseconds Duration_t;
+
+  LatencyHistogram() { clear(); }
+
+  void add(Duration_t duration);
+  void clear();
+
+  std::uint64_t count() const { return count_; }
+  /// Mean duration, in seconds.
+  double mean() const;
+  /// Maximal duration, in seconds.
+  double max() const;
+  /// \brief Upper bound of the quantile q, in seconds.
+  /// \param q in [0, 1], e.g. 0.99 for the 99th percentile.
+  double quantile(double q) const;
+
+ private:
+  static const int nbBuckets = 152;
+
+  std::uint64_t buckets_[nbBuckets];
+  std::uint64_t count_;
+  std::uint64_t sum_;
+  std::uint64_t max_;
+};
+
+/// \brief Latencies of the commands executed by an Interpreter.
+///
+/// The duration of each phase of the execution of a command is recorded, as
+/// well as the total duration of each distinct command.
+struct DYNAMIC_GRAPH_PYTHON_DLLAPI LatencyStats {
+  enum Phase {
+    /// Waiting for the GIL
+    GIL_WAIT,
+    /// Compiling the command as an expression, or finding it in the code cache.
+    PARSE,
+    /// Compiling the command as a statement, when it is not an expression.
+    SINGLE_FALLBACK,
+    /// Executing the command
+    EXECUTE,
+    /// Fetching the standard output and the error
+    FETCH_OUTPUT,
+    /// Converting the result (into a string or a Value)
+    CONVERT_RESULT,
+    /// From the call to the return
+    TOTAL,
+    NB_PHASES
+  };
+  static const char* phaseName(Phase phase);
+
+  /// Maximal number of distinct commands whose latencies are recorded.
+  static const std::size_t maxCommands = 1024;
+
+  LatencyStats() : enabled(false) {}
+  LatencyStats(const LatencyStats& other);
+  LatencyStats& operator=(const LatencyStats& other);
+
+  void add(Phase phase, LatencyHistogram::Duration_t duration) { phases[phase].add(duration); }
+  void addCommand(const std::string& command, LatencyHistogram::Duration_t duration);
+  void clear();
+
+  /// Whether durations are recorded.
+  std::atomic<bool> enabled;
+  LatencyHistogram phases[NB_PHASES];
+  std::unordered_map<std::string, LatencyHistogram> commands;
+};
+
+}  // namespace python
+}  // namespace dynamicgraph
+
+#endif  // DYNAMIC_GRAPH_PYTHON_LATENCY_STATS_HH
@@ -9,4 +9,34 @@
 // Get any PyObject and get its str() representation as an std::string
 std::string obj_to_str(PyObject* o);
 
+namespace dynamicgraph {
+namespace python {
+/// Release the GIL during the lifetime of the object.
+class AllowThreads {
+ public:
+  AllowThreads() : state_(PyEval_SaveThread()) {}
+  ~AllowThreads() { PyEval_RestoreThread(state_); }
+
+ private:
+  AllowThreads(const AllowThreads&);
+  AllowThreads& operator=(const AllowThreads&);
+
+  PyThreadState* state_;
+};
+
+/// Hold the GIL during the lifetime of the object, from any thread.
+class EnsureGIL {
+ public:
+  EnsureGIL() : state_(PyGILState_Ensure()) {}
+  ~EnsureGIL() { PyGILState_Release(state_); }
+
+ private:
+  EnsureGIL(const EnsureGIL&);
+  EnsureGIL& operator=(const EnsureGIL&);
+
+  PyGILState_STATE state_;
+};
+}  // namespace python
+}  // namespace dynamicgraph
+
 #endif
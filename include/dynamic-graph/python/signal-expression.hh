@@ -0,0 +1,432 @@
+// -*- mode: c++ -*-
+// Copyright 2026, CNRS.
+
+#ifndef DYNAMIC_GRAPH_PYTHON_SIGNAL_EXPRESSION_HH
+#define DYNAMIC_GRAPH_PYTHON_SIGNAL_EXPRESSION_HH
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/python.hpp>
+
+#include <dynamic-graph/signal-time-dependent.h>
+#include <dynamic-graph/signal.h>
+
+#include "dynamic-graph/python/buffer.hh"
+#include "dynamic-graph/python/value-storage.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+/// \brief Build signals computing arithmetic expressions of other signals.
+///
+/// The operators of the Python classes of the signals create
+/// SignalTimeDependent signals depending on their operands, computed in C++
+/// without the GIL. The kernels are instantiated for each type, hence
+/// specialized for the types of fixed size.
+///
+/// The Python object returned by an operator owns the signal, and keeps the
+/// Python objects of the operands alive: keep it as long as the signal is
+/// used, e.g. plugged into an entity. The signals of entities used as
+/// operands must outlive it.
+namespace expression {
+
+/// \brief An operand: the value of a signal, or a constant.
+template <class T>
+struct Operand {
+  Signal<T, int>* signal;
+  T constant;
+
+  const T& operator()(const int& t) const { return (signal != NULL ? signal->access(t) : constant); }
+  std::string name() const { return (signal != NULL ? signal->getName() : std::string("constant")); }
+};
+
+/// \brief The categories of types supporting the operators.
+template <class T>
+struct Traits {
+  static const bool scalar = false;
+  static const bool matrix = false;
+  static const bool vector = false;
+};
+
+template <>
+struct Traits<double> {
+  static const bool scalar = true;
+  static const bool matrix = false;
+  static const bool vector = false;
+};
+
+template <int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct Traits<Eigen::Matrix<double, Rows, Cols, Options, MaxRows, MaxCols> > {
+  static const bool scalar = false;
+  static const bool matrix = true;
+  static const bool vector = (Cols == 1);
+};
+
+/// Values of the exposed signals whose elements are selected by slices.
+typedef Eigen::VectorXd Vector;
+
+template <class A, class B>
+void checkSameShape(const A& a, const B& b, const char* op) {
+  if (a.rows() != b.rows() || a.cols() != b.cols())
+    throw std::runtime_error(std::string("signal expression: operands of ") + op + " of different shapes.");
+}
+
+inline void checkSameShape(const double&, const double&, const char*) {}
+
+struct Add {
+  static const char* name() { return "+"; }
+  template <class R, class A, class B>
+  static void apply(R& res, const A& a, const B& b) {
+    checkSameShape(a, b, name());
+    res = a + b;
+  }
+};
+
+struct Sub {
+  static const char* name() { return "-"; }
+  template <class R, class A, class B>
+  static void apply(R& res, const A& a, const B& b) {
+    checkSameShape(a, b, name());
+    res = a - b;
+  }
+};
+
+/// Element-wise product, as numpy.
+struct Mul {
+  static const char* name() { return "*"; }
+  static void apply(double& res, const double& a, const double& b) { res = a * b; }
+  template <class R, class A, class B>
+  static void apply(R& res, const A& a, const B& b) {
+    checkSameShape(a, b, name());
+    res = a.cwiseProduct(b);
+  }
+};
+
+/// Operations between a matrix and a scalar, applied to each element.
+template <class Op>
+struct Broadcast {
+  static const char* name() { return Op::name(); }
+  template <class R, class A>
+  static void apply(R& res, const A& a, const double& b) {
+    res.resize(a.rows(), a.cols());
+    Op::apply(res.array(), a.array(), b);
+  }
+  template <class R, class B>
+  static void apply(R& res, const double& a, const B& b) {
+    res.resize(b.rows(), b.cols());
+    Op::apply(res.array(), a, b.array());
+  }
+};
+
+struct ArrayAdd {
+  static const char* name() { return "+"; }
+  template <class R, class A, class B>
+  static void apply(R&& res, const A& a, const B& b) {
+    res = a + b;
+  }
+};
+
+struct ArraySub {
+  static const char* name() { return "-"; }
+  template <class R, class A, class B>
+  static void apply(R&& res, const A& a, const B& b) {
+    res = a - b;
+  }
+};
+
+struct ArrayMul {
+  static const char* name() { return "*"; }
+  template <class R, class A, class B>
+  static void apply(R&& res, const A& a, const B& b) {
+    res = a * b;
+  }
+};
+
+/// Matrix product, the operator @.
+struct MatMul {
+  static const char* name() { return "@"; }
+  template <class R, class A, class B>
+  static void apply(R& res, const A& a, const B& b) {
+    res = a * b;
+  }
+  template <class R, int ARows, int ACols, int AOptions, int AMaxRows, int AMaxCols, int BRows, int BCols, int BOptions,
+            int BMaxRows, int BMaxCols>
+  static void apply(R& res, const Eigen::Matrix<double, ARows, ACols, AOptions, AMaxRows, AMaxCols>& a,
+                    const Eigen::Matrix<double, BRows, BCols, BOptions, BMaxRows, BMaxCols>& b) {
+    if (a.cols() != b.rows()) throw std::runtime_error("signal expression: operands of @ of incompatible shapes.");
+    res.noalias() = a * b;
+  }
+  template <class R>
+  static void apply(R& res, const Eigen::Quaternion<double>& a, const Eigen::Vector3d& b) {
+    res = a._transformVector(b);
+  }
+};
+
+/// The function of a signal computing a op b.
+template <class R, class A, class B, class Op>
+struct Binary {
+  Operand<A> a;
+  Operand<B> b;
+
+  R& operator()(R& res, const int& t) const {
+    Op::apply(res, a(t), b(t));
+    return res;
+  }
+};
+
+template <class R, class A>
+struct Negate {
+  Operand<A> a;
+
+  R& operator()(R& res, const int& t) const {
+    res = -a(t);
+    return res;
+  }
+};
+
+/// Python slices, which indices depend on the size of the sequence.
+struct Slice {
+  Py_ssize_t start, stop, step;
+  bool hasStart, hasStop;
+
+  /// The first index and the number of elements in a sequence of size n.
+  void indices(Py_ssize_t n, Py_ssize_t& first, Py_ssize_t& count) const {
+    Py_ssize_t begin = start, end = stop;
+    if (!hasStart) begin = (step > 0 ? 0 : n - 1);
+    if (!hasStop) end = (step > 0 ? n : -n - 1);
+    if (begin < 0) begin += n;
+    if (end < 0) end += n;
+    if (step > 0) {
+      begin = std::max<Py_ssize_t>(0, std::min(begin, n));
+      end = std::max<Py_ssize_t>(0, std::min(end, n));
+      count = (end > begin ? (end - begin + step - 1) / step : 0);
+    } else {
+      begin = std::max<Py_ssize_t>(-1, std::min(begin, n - 1));
+      end = std::max<Py_ssize_t>(-1, std::min(end, n - 1));
+      count = (begin > end ? (begin - end - step - 1) / -step : 0);
+    }
+    first = begin;
+  }
+};
+
+template <class A>
+struct SliceElements {
+  Operand<A> a;
+  Slice slice;
+
+  Vector& operator()(Vector& res, const int& t) const {
+    const A& value = a(t);
+    Py_ssize_t first, count;
+    slice.indices(value.size(), first, count);
+    res.resize(count);
+    for (Py_ssize_t i = 0; i < count; ++i) res[i] = value[first + i * slice.step];
+    return res;
+  }
+};
+
+template <class A>
+struct Element {
+  Operand<A> a;
+  Py_ssize_t index;
+
+  double& operator()(double& res, const int& t) const {
+    const A& value = a(t);
+    const Py_ssize_t i = (index < 0 ? index + value.size() : index);
+    if (i < 0 || i >= value.size())
+      throw std::out_of_range("signal expression: index " + std::to_string(index) + " out of range for " +
+                              a.name() + ".");
+    res = value[i];
+    return res;
+  }
+};
+
+/// \brief Create a signal computed by function, depending on the signals of
+///        the operands.
+/// \return a Python object owning the signal, which keeps operands alive.
+template <class R, class Function>
+boost::python::object makeSignal(const std::string& name, const Function& function,
+                                 const std::vector<SignalBase<int>*>& dependencies, boost::python::object operands) {
+  namespace bp = boost::python;
+  typedef SignalTimeDependent<R, int> S_t;
+  std::unique_ptr<S_t> signal(new S_t(name));
+  signal->setFunction(function);
+  for (SignalBase<int>* dependency : dependencies)
+    if (dependency != NULL) signal->addDependency(*dependency);
+  typedef typename bp::manage_new_object::apply<S_t*>::type Owner;
+  bp::object res(bp::handle<>(Owner()(signal.get())));
+  signal.release();
+  res.attr("_operands") = operands;
+  return res;
+}
+
+inline boost::python::object notImplemented() {
+  return boost::python::object(boost::python::handle<>(boost::python::borrowed(Py_NotImplemented)));
+}
+
+/// \brief Convert o into a constant of type T.
+/// \return false if o cannot be converted.
+template <class T>
+bool constant(boost::python::object, T&) {
+  return false;
+}
+
+inline bool constant(boost::python::object o, double& value) {
+  if (!PyFloat_Check(o.ptr()) && !PyLong_Check(o.ptr())
+#if PY_MAJOR_VERSION < 3
+      && !PyInt_Check(o.ptr())
+#endif
+  )
+    return false;
+  value = boost::python::extract<double>(o);
+  return true;
+}
+
+template <int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+bool constant(boost::python::object o, Eigen::Matrix<double, Rows, Cols, Options, MaxRows, MaxCols>& value) {
+  namespace bp = boost::python;
+  typedef Eigen::Matrix<double, Rows, Cols, Options, MaxRows, MaxCols> T;
+  // Signals of other types are not constants.
+  if (bp::extract<SignalBase<int>&>(o).check()) return false;
+  bp::object array;
+  try {
+    array = bp::import("numpy").attr("asarray")(o, "float64");
+  } catch (const bp::error_already_set&) {
+    PyErr_Clear();
+    return false;
+  }
+  Buffer buffer(array.ptr());
+  if (!buffer.valid() || buffer.ndim() != (Cols == 1 ? 1 : 2)) return false;
+  if ((Rows != Eigen::Dynamic && buffer.rows() != Rows) || (Cols != Eigen::Dynamic && buffer.cols() != Cols))
+    return false;
+  value.resize(buffer.rows(), buffer.cols());
+  copyArray(buffer, ValueStorage<T>::layout(value));
+  return true;
+}
+
+/// \brief Convert o into an operand of type T.
+/// \return false if o is neither a signal of type T nor a constant.
+template <class T>
+bool operand(boost::python::object o, Operand<T>& res) {
+  boost::python::extract<Signal<T, int>&> signal(o);
+  if (signal.check()) {
+    res.signal = &signal();
+    return true;
+  }
+  res.signal = NULL;
+  return constant(o, res.constant);
+}
+
+/// \brief The signal computing a op b.
+/// \param pa, pb the Python objects of a and b.
+template <class R, class A, class B, class Op>
+boost::python::object binary(const Operand<A>& a, const Operand<B>& b, boost::python::object pa,
+                             boost::python::object pb) {
+  Binary<R, A, B, Op> function = {a, b};
+  return makeSignal<R>("(" + a.name() + " " + Op::name() + " " + b.name() + ")", function, {a.signal, b.signal},
+                       boost::python::make_tuple(pa, pb));
+}
+
+/// \brief self op other, or other op self if reflected, with operands of type T.
+template <class T, class Op>
+boost::python::object sameType(boost::python::object self, boost::python::object other, bool reflected) {
+  Operand<T> a = {&boost::python::extract<Signal<T, int>&>(self)(), T()}, b;
+  if (!operand(other, b)) return boost::python::object();
+  return (reflected ? binary<T, T, T, Op>(b, a, other, self) : binary<T, T, T, Op>(a, b, self, other));
+}
+
+/// \brief self op other, or other op self if reflected, other being a scalar.
+template <class T, class Op>
+boost::python::object withScalar(boost::python::object self, boost::python::object other, bool reflected) {
+  Operand<T> a = {&boost::python::extract<Signal<T, int>&>(self)(), T()};
+  Operand<double> b;
+  if (!operand(other, b)) return boost::python::object();
+  return (reflected ? binary<T, double, T, Broadcast<Op> >(b, a, other, self)
+                    : binary<T, T, double, Broadcast<Op> >(a, b, self, other));
+}
+
+template <class T, class Op, class ArrayOp>
+boost::python::object arithmetic(boost::python::object self, boost::python::object other, bool reflected,
+                                 std::true_type) {
+  boost::python::object res = sameType<T, Op>(self, other, reflected);
+  if (res.is_none()) res = withScalar<T, ArrayOp>(self, other, reflected);
+  return (res.is_none() ? notImplemented() : res);
+}
+
+template <class T, class Op, class ArrayOp>
+boost::python::object arithmetic(boost::python::object self, boost::python::object other, bool reflected,
+                                 std::false_type) {
+  boost::python::object res = sameType<T, Op>(self, other, reflected);
+  return (res.is_none() ? notImplemented() : res);
+}
+
+template <class T, class Op, class ArrayOp, bool Reflected>
+boost::python::object binaryOperator(boost::python::object self, boost::python::object other) {
+  return arithmetic<T, Op, ArrayOp>(self, other, Reflected, std::integral_constant<bool, Traits<T>::matrix>());
+}
+
+template <class T>
+boost::python::object negate(boost::python::object pself) {
+  Signal<T, int>& self = boost::python::extract<Signal<T, int>&>(pself);
+  Negate<T, T> function = {{&self, T()}};
+  return makeSignal<T>("(-" + self.getName() + ")", function, {&self}, boost::python::make_tuple(pself));
+}
+
+template <class T>
+boost::python::object getItem(boost::python::object pself, boost::python::object key) {
+  namespace bp = boost::python;
+  Signal<T, int>& self = bp::extract<Signal<T, int>&>(pself);
+  Operand<T> a = {&self, T()};
+  if (PySlice_Check(key.ptr())) {
+    bp::object start = key.attr("start"), stop = key.attr("stop"), step = key.attr("step");
+    SliceElements<T> function = {a, {0, 0, 1, !start.is_none(), !stop.is_none()}};
+    if (function.slice.hasStart) function.slice.start = bp::extract<Py_ssize_t>(start);
+    if (function.slice.hasStop) function.slice.stop = bp::extract<Py_ssize_t>(stop);
+    if (!step.is_none()) function.slice.step = bp::extract<Py_ssize_t>(step);
+    if (function.slice.step == 0) throw std::invalid_argument("slice step cannot be zero");
+    std::string name = (function.slice.hasStart ? std::to_string(function.slice.start) : "") + ":" +
+                       (function.slice.hasStop ? std::to_string(function.slice.stop) : "");
+    if (function.slice.step != 1) name += ":" + std::to_string(function.slice.step);
+    return makeSignal<Vector>(self.getName() + "[" + name + "]", function, {&self}, bp::make_tuple(pself));
+  }
+  Element<T> function = {a, bp::extract<Py_ssize_t>(key)()};
+  return makeSignal<double>(self.getName() + "[" + std::to_string(function.index) + "]", function, {&self},
+                            bp::make_tuple(pself));
+}
+
+template <class T, class Class>
+void addSlices(Class&, std::false_type) {}
+
+template <class T, class Class>
+void addSlices(Class& obj, std::true_type) {
+  obj.def("__getitem__", &getItem<T>,
+          "Return a signal computing an element of the value, for an integer\n"
+          "key, or a vector of the elements selected by a slice.");
+}
+
+template <class T, class Class>
+void addOperators(Class&, std::false_type) {}
+
+template <class T, class Class>
+void addOperators(Class& obj, std::true_type) {
+  // numpy arrays let the signals implement the operators with arrays.
+  obj.setattr("__array_ufunc__", boost::python::object());
+  obj.def("__add__", &binaryOperator<T, Add, ArrayAdd, false>);
+  obj.def("__radd__", &binaryOperator<T, Add, ArrayAdd, true>);
+  obj.def("__sub__", &binaryOperator<T, Sub, ArraySub, false>);
+  obj.def("__rsub__", &binaryOperator<T, Sub, ArraySub, true>);
+  obj.def("__mul__", &binaryOperator<T, Mul, ArrayMul, false>);
+  obj.def("__rmul__", &binaryOperator<T, Mul, ArrayMul, true>);
+  obj.def("__neg__", &negate<T>);
+  addSlices<T>(obj, std::integral_constant<bool, Traits<T>::vector>());
+}
+
+}  // namespace expression
+}  // namespace python
+}  // namespace dynamicgraph
+
+#endif  // DYNAMIC_GRAPH_PYTHON_SIGNAL_EXPRESSION_HH
@@ -0,0 +1,63 @@
+// -*- mode: c++ -*-
+// Copyright 2026, CNRS.
+
+#ifndef DYNAMIC_GRAPH_PYTHON_SIGNAL_GROUP_HH
+#define DYNAMIC_GRAPH_PYTHON_SIGNAL_GROUP_HH
+
+#include <vector>
+
+#include "dynamic-graph/python/value-access.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+/// \brief Copy the values of many signals from or into a single array.
+///
+/// The values are stored one after the other, each of them in row-major
+/// order. The types of the signals and the shapes of their values are
+/// checked once, when the group is built. The signals must outlive the group.
+class DYNAMIC_GRAPH_PYTHON_DLLAPI SignalGroup {
+ public:
+  /// Position of the value of a signal in the array.
+  struct Entry {
+    SignalBase<int>* signal;
+    const ValueAccess* access;
+    /// Index of the first element
+    std::size_t offset;
+    /// The shape of the value. Only ndim and shape are meaningful.
+    ArrayLayout layout;
+  };
+
+  /// \throw std::invalid_argument if the values of a signal are not stored as
+  ///        arrays of double.
+  explicit SignalGroup(const std::vector<SignalBase<int>*>& signals);
+
+  const std::vector<Entry>& entries() const { return entries_; }
+  /// The number of elements of the array.
+  std::size_t size() const { return size_; }
+
+  /// \brief Recompute the signals at time t, in order.
+  void recompute(const int& t) const;
+
+  /// \brief Copy the current values of the signals into data, of size size().
+  /// \throw std::runtime_error if the shape of a value changed since the
+  ///        group was built.
+  void read(double* data) const;
+  /// \brief Copy data, of size size(), into the values of the signals.
+  ///
+  /// The values are modified in place. Signals which are not constant are
+  /// made constant, as with setConstant. All the signals are marked as
+  /// updated.
+  /// \throw std::runtime_error if the shape of a value changed since the
+  ///        group was built.
+  void write(const double* data) const;
+
+ private:
+  std::vector<Entry> entries_;
+  std::size_t size_;
+};
+
+}  // namespace python
+}  // namespace dynamicgraph
+
+#endif  // DYNAMIC_GRAPH_PYTHON_SIGNAL_GROUP_HH
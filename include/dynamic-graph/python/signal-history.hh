@@ -0,0 +1,87 @@
+// -*- mode: c++ -*-
+// Copyright 2026, CNRS.
+
+#ifndef DYNAMIC_GRAPH_PYTHON_SIGNAL_HISTORY_HH
+#define DYNAMIC_GRAPH_PYTHON_SIGNAL_HISTORY_HH
+
+#include <vector>
+
+#include <dynamic-graph/signal-time-dependent.h>
+
+#include "dynamic-graph/python/value-access.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+/// \brief Record the last values of a signal in a ring buffer.
+///
+/// The memory is allocated once, when the history is built: recording a
+/// value only copies it. The values are stored one after the other, each of
+/// them in row-major order, the oldest one first from index begin().
+///
+/// Values are recorded by record(), or each time the trigger signal is
+/// recomputed, e.g. by adding it to the signals recomputed periodically by a
+/// device. Recording and reading the history are not synchronized: read it
+/// while it is not recorded. The signal must outlive the history.
+///
+/// The trigger signal outlives the history, as other signals may still depend
+/// on it: when the history is destroyed, its dependencies are cleared and
+/// recomputing it does nothing.
+class DYNAMIC_GRAPH_PYTHON_DLLAPI SignalHistory {
+ public:
+  /// \param capacity the maximal number of values kept.
+  /// \throw std::invalid_argument if the values of the signal are not stored
+  ///        as arrays of double, if they are empty or if capacity is zero.
+  SignalHistory(SignalBase<int>& signal, std::size_t capacity);
+  ~SignalHistory();
+
+  SignalBase<int>& signal() const { return signal_; }
+  /// The signal recording the value of the signal when recomputed.
+  SignalTimeDependent<int, int>& trigger() { return *trigger_; }
+
+  std::size_t capacity() const { return capacity_; }
+  /// The number of values kept, at most capacity().
+  std::size_t size() const { return size_; }
+  /// The number of elements of each value.
+  std::size_t valueSize() const { return valueSize_; }
+  /// The shape of the values. Only ndim and shape are meaningful.
+  const ArrayLayout& valueLayout() const { return valueLayout_; }
+
+  /// Index of the oldest value in the ring buffer.
+  std::size_t begin() const { return (head_ + capacity_ - size_) % capacity_; }
+  /// The ring buffer of capacity() values.
+  double* data() { return &data_[0]; }
+  /// The time of each value of the ring buffer.
+  const std::vector<int>& times() const { return times_; }
+
+  /// \brief Recompute the signal at time t and record its value.
+  ///
+  /// Nothing is recorded if the last recorded value is from time t.
+  /// \throw std::runtime_error if the shape of the value changed since the
+  ///        history was built.
+  void record(const int& t);
+  /// \brief Copy the values, oldest first, into dst of size size() * valueSize().
+  void copyTo(double* dst) const;
+  void clear() { size_ = 0; }
+
+ private:
+  SignalHistory(const SignalHistory&);
+  SignalHistory& operator=(const SignalHistory&);
+
+  int& recordTrigger(int& dummy, const int& t);
+
+  SignalBase<int>& signal_;
+  const ValueAccess* access_;
+  ArrayLayout valueLayout_;
+  std::size_t valueSize_, capacity_;
+  /// Index of the next recorded value and number of values kept.
+  std::size_t head_, size_;
+  std::vector<double> data_;
+  std::vector<int> times_;
+  SignalTimeDependent<int, int>* trigger_;
+};
+
+}  // namespace python
+}  // namespace dynamicgraph
+
+#endif  // DYNAMIC_GRAPH_PYTHON_SIGNAL_HISTORY_HH
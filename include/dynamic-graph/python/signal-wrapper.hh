@@ -7,10 +7,25 @@
 #include <boost/python.hpp>
 #include <boost/bind.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
 #include <dynamic-graph/linear-algebra.h>
 #include <dynamic-graph/signal.h>
 #include <dynamic-graph/entity.h>
+#include "dynamic-graph/python/api.hh"
+#include "dynamic-graph/python/buffer.hh"
 #include "dynamic-graph/python/python-compat.hh"
+#include "dynamic-graph/python/value-storage.hh"
 
 namespace dynamicgraph {
 namespace python {
@@ -26,6 +41,53 @@ class PythonSignalContainer : public Entity {
   void rmSignal(const std::string& name);
 };
 
+namespace internal {
+/// Convert Python objects into values of type T.
+template <class T>
+struct ValueFromPython {
+  static void assign(T& value, boost::python::object obj) { value = boost::python::extract<T>(obj); }
+};
+
+/// Transforms are converted from their matrix.
+template <int Dim, int Mode, int Options>
+struct ValueFromPython<Eigen::Transform<double, Dim, Mode, Options> > {
+  typedef Eigen::Transform<double, Dim, Mode, Options> T;
+  static void assign(T& value, boost::python::object obj) {
+    value.matrix() = boost::python::extract<typename T::MatrixType>(obj)();
+  }
+};
+
+template <class T>
+void assignFromPython(T& value, boost::python::object obj, std::false_type) {
+  ValueFromPython<T>::assign(value, obj);
+}
+
+/// Arrays of double of the shape of value are copied into it directly.
+template <class T>
+void assignFromPython(T& value, boost::python::object obj, std::true_type) {
+  Buffer buffer(obj.ptr());
+  ArrayLayout layout = ValueStorage<T>::layout(value);
+  if (sameShape(buffer, layout))
+    copyArray(buffer, layout);
+  else
+    ValueFromPython<T>::assign(value, obj);
+}
+
+template <class T>
+boost::python::object outParameter(T&, const T&, std::false_type) {
+  return boost::python::object();
+}
+
+/// A writable view of value, resized first to the shape of previous for types of variable size.
+template <class T>
+boost::python::object outParameter(T& value, const T& previous, std::true_type) {
+  if (!ValueStorage<T>::fixedSize &&
+      !ValueStorage<T>::layout(value).sameShape(ValueStorage<T>::layout(const_cast<T&>(previous))))
+    value = previous;
+  return boost::python::object(boost::python::handle<>(arrayView(ValueStorage<T>::layout(value), true, NULL)));
+}
+}  // namespace internal
+
 template <class T, class Time>
 class SignalWrapper : public Signal<T, Time> {
  public:
@@ -34,7 +96,12 @@ class SignalWrapper : public Signal<T, Time> {
 
   static bool checkCallable(pyobject c, std::string& error);
 
-  SignalWrapper(std::string name, pyobject callable) : parent_t(name), callable(callable) {
+  /// \param outParameter whether callable is called as callable(t, out), with
+  ///        out a writable numpy array sharing the memory of the value to
+  ///        compute, instead of callable(t). Only for the types whose values
+  ///        are arrays of double.
+  SignalWrapper(std::string name, pyobject callable, bool outParameter = false)
+      : parent_t(name), callable(callable), outParameter(outParameter) {
     typedef boost::function2<T&, T&, Time> function_t;
     function_t f = boost::bind(&SignalWrapper::call, this, _1, _2);
     this->setFunction(f);
@@ -49,12 +116,355 @@ class SignalWrapper : public Signal<T, Time> {
     if (PyGILState_GetThisThreadState() == NULL) {
       dgDEBUG(10) << "python thread not initialized" << std::endl;
     }
-    pyobject obj = callable(t);
-    value = boost::python::extract<T>(obj);
+    try {
+      typedef std::integral_constant<bool, ValueStorage<T>::viewable> viewable;
+      if (outParameter) {
+        // The value is computed in place, unless another one is returned.
+        pyobject obj = callable(t, internal::outParameter(value, this->accessCopy(), viewable()));
+        if (!obj.is_none()) internal::assignFromPython(value, obj, viewable());
+      } else {
+        pyobject obj = callable(t);
+        internal::assignFromPython(value, obj, viewable());
+      }
+    } catch (...) {
+      PyGILState_Release(gstate);
+      throw;
+    }
     PyGILState_Release(gstate);
     return value;
   }
   pyobject callable;
+  bool outParameter;
+};
+
+template <class T, class Time>
+bool SignalWrapper<T, Time>::checkCallable(pyobject c, std::string& error) {
+  if (PyCallable_Check(c.ptr()) == 0) {
+    error = boost::python::extract<std::string>(c.attr("__str__")());
+    error += " is not callable";
+    return false;
+  }
+  return true;
+}
+
+/// \brief A thread taking the GIL, stopped when the Python interpreter exits.
+///
+/// The instances register themselves at construction. stopAll is registered
+/// with atexit by the dynamic_graph module, so that no thread takes the GIL
+/// of an interpreter being finalized.
+class DYNAMIC_GRAPH_PYTHON_DLLAPI AsyncSignalThread {
+ public:
+  AsyncSignalThread();
+  virtual ~AsyncSignalThread();
+
+  /// Stop and join the thread, if not done yet.
+  virtual void stop() = 0;
+
+  /// Stop the threads of all the instances.
+  static void stopAll();
+
+ protected:
+  /// Remove the instance from the ones stopped by stopAll. To be called
+  /// first by the destructor of the derived class, before stopping the thread.
+  void unregister();
+
+ private:
+  AsyncSignalThread(const AsyncSignalThread&);
+  AsyncSignalThread& operator=(const AsyncSignalThread&);
+};
+
+/// \brief A signal whose value is computed by a Python callable in a
+///        dedicated thread.
+///
+/// Recomputing the signal at time t requests the value at time t from the
+/// thread and returns the latest value computed, possibly for an earlier
+/// time, without waiting nor taking the GIL. The values are exchanged through
+/// a lock-free triple buffer. Before the first value is computed, the value
+/// is the default one. When the callable raises an error, the previous value
+/// is kept. Only the first of consecutive errors is printed.
+///
+/// Recomputing the signal does not notify the thread either, as notifying a
+/// condition variable may be a system call: the thread polls the requests
+/// every 10 ms. A request is therefore only handled up to 10 ms after it was
+/// made, in addition to the time taken to compute the value.
+///
+/// The thread is stopped when the Python interpreter exits, after which the
+/// value is not updated anymore.
+template <class T, class Time>
+class AsyncSignalWrapper : public Signal<T, Time>, public AsyncSignalThread {
+ public:
+  typedef Signal<T, Time> parent_t;
+  typedef boost::python::object pyobject;
+
+  /// \param outParameter see SignalWrapper.
+  AsyncSignalWrapper(std::string name, pyobject callable, bool outParameter = false)
+      : parent_t(name),
+        callable_(callable),
+        outParameter_(outParameter),
+        failing_(false),
+        stop_(false),
+        requested_(Time()),
+        requests_(0),
+        back_(0),
+        previous_(0),
+        middle_(1),
+        front_(2),
+        valueTime_(Time()),
+        valueStamp_(0) {
+    typedef boost::function2<T&, T&, Time> function_t;
+    function_t f = boost::bind(&AsyncSignalWrapper::read, this, _1, _2);
+    this->setFunction(f);
+    thread_ = std::thread(&AsyncSignalWrapper::run, this);
+  }
+
+  virtual ~AsyncSignalWrapper() {
+    this->unregister();
+    stop();
+  }
+
+  virtual void stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    condition_.notify_one();
+    if (!thread_.joinable()) return;
+#if PY_MAJOR_VERSION >= 3
+    // The thread may be waiting for the GIL.
+    if (PyGILState_Check()) {
+      AllowThreads allowThreads;
+      thread_.join();
+      return;
+    }
+#endif
+    thread_.join();
+  }
+
+  /// Whether a value was computed.
+  bool hasValue() const { return valueStamp_.load() != 0; }
+  /// The time at which the current value was requested.
+  Time valueTime() const { return valueTime_.load(); }
+  /// The number of seconds elapsed since the current value was computed,
+  /// infinity if there is no value yet.
+  double valueAge() const {
+    std::int64_t stamp = valueStamp_.load();
+    if (stamp == 0) return std::numeric_limits<double>::infinity();
+    return double(now() - stamp) * 1e-9;
+  }
+
+ private:
+  struct Slot {
+    T value;
+    Time time;
+    /// When the value was computed, in nanoseconds.
+    std::int64_t stamp;
+  };
+  /// Flag of middle_ telling that the slot was written since it was last read.
+  static const int FRESH = 4;
+
+  static std::int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /// The function of the signal, called by the thread recomputing it.
+  T& read(T& value, Time t) {
+    requested_.store(t);
+    requests_.fetch_add(1);
+    if (middle_.load() & FRESH) {
+      front_ = middle_.exchange(front_) & ~FRESH;
+      valueTime_.store(slots_[front_].time);
+      valueStamp_.store(slots_[front_].stamp);
+    }
+    value = slots_[front_].value;
+    return value;
+  }
+
+  /// The loop of the thread computing the values.
+  void run() {
+    unsigned handled = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      // Requests are not notified, so that recomputing the signal does not
+      // make system calls: poll them. Only stopping is notified.
+      condition_.wait_for(lock, std::chrono::milliseconds(10),
+                          [&] { return stop_ || requests_.load() != handled; });
+      if (stop_) break;
+      if (requests_.load() == handled) continue;
+      handled = requests_.load();
+      Time t = requested_.load();
+      lock.unlock();
+      if (compute(slots_[back_].value, t)) {
+        slots_[back_].time = t;
+        slots_[back_].stamp = now();
+        previous_ = back_;
+        back_ = middle_.exchange(back_ | FRESH) & ~FRESH;
+      }
+      lock.lock();
+    }
+  }
+
+  bool compute(T& value, Time t) {
+    typedef std::integral_constant<bool, ValueStorage<T>::viewable> viewable;
+    EnsureGIL gil;
+    try {
+      if (outParameter_) {
+        pyobject obj = callable_(t, internal::outParameter(value, slots_[previous_].value, viewable()));
+        if (!obj.is_none()) internal::assignFromPython(value, obj, viewable());
+      } else {
+        pyobject obj = callable_(t);
+        internal::assignFromPython(value, obj, viewable());
+      }
+      failing_ = false;
+      return true;
+    } catch (const boost::python::error_already_set&) {
+      if (failing_)
+        PyErr_Clear();
+      else
+        PyErr_Print();
+    } catch (const std::exception& e) {
+      if (!failing_) std::cerr << this->getName() << ": " << e.what() << std::endl;
+    }
+    failing_ = true;
+    return false;
+  }
+
+  pyobject callable_;
+  bool outParameter_;
+  /// Whether the last computation failed.
+  bool failing_;
+
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool stop_;
+  std::atomic<Time> requested_;
+  std::atomic<unsigned> requests_;
+
+  Slot slots_[3];
+  /// The slot written by the thread computing the values, and the last one
+  /// it wrote.
+  int back_, previous_;
+  /// The slot exchanged between the threads, with the flag FRESH.
+  std::atomic<int> middle_;
+  /// The slot read by the thread recomputing the signal.
+  int front_;
+  std::atomic<Time> valueTime_;
+  std::atomic<std::int64_t> valueStamp_;
+};
+
+/// \brief A signal whose value is computed by a native function, e.g.
+///        compiled with cffi or ctypes, called without the GIL.
+///
+/// The function is called as function(out, t, user), with out the elements
+/// of the value to compute, in the order in which they are stored:
+/// column-major for matrices, x, y, z, w for quaternions. Only for the types
+/// whose values are arrays of double of fixed size.
+template <class T, class Time>
+class NativeSignalWrapper : public Signal<T, Time> {
+ public:
+  typedef Signal<T, Time> parent_t;
+  typedef void (*Function)(double* out, int t, void* user);
+
+  /// \param owner Python objects providing function and user, kept alive.
+  NativeSignalWrapper(std::string name, Function function, void* user, boost::python::object owner)
+      : parent_t(name), function_(function), user_(user), owner_(owner) {
+    typedef boost::function2<T&, T&, Time> function_t;
+    function_t f = boost::bind(&NativeSignalWrapper::call, this, _1, _2);
+    this->setFunction(f);
+  }
+
+ private:
+  T& call(T& value, Time t) {
+    function_(ValueStorage<T>::layout(value).data, static_cast<int>(t), user_);
+    return value;
+  }
+
+  Function function_;
+  void* user_;
+  boost::python::object owner_;
+};
+
+/// \brief The functions creating the signals of create_signal_wrapper, by
+///        name of the type of the signal.
+///
+/// The types of the commands, and the types of the exposed signals whose
+/// values are arrays of double, are registered by the python module. Other
+/// modules may register their own types, typically with
+/// SignalWrapperFactory::add("MyType", &SignalWrapperFactory::create<MyType>).
+class DYNAMIC_GRAPH_PYTHON_DLLAPI SignalWrapperFactory {
+ public:
+  /// How the callable computes the values.
+  enum Flags {
+    /// See SignalWrapper.
+    OUT_PARAMETER = 1,
+    /// Create an AsyncSignalWrapper.
+    ASYNCHRONOUS = 2,
+    /// Create a NativeSignalWrapper. The callable is a tuple (function,
+    /// user) of objects accepted by address().
+    NATIVE = 4
+  };
+  /// Return a new signal, or NULL and set error.
+  /// \param flags a combination of Flags.
+  typedef SignalBase<int>* (*Creator)(const std::string& name, boost::python::object callable, int flags,
+                                      std::string& error);
+
+  /// \brief Register creator for type, replacing the previous one, if any.
+  static void add(const std::string& type, Creator creator);
+  /// \brief Return the creator of the signals of type, or NULL.
+  static Creator find(const std::string& type);
+  /// \brief The registered types, sorted.
+  static std::vector<std::string> types();
+
+  /// \brief Whether o is a ctypes or cffi function pointer.
+  static bool isNativeFunction(boost::python::object o);
+  /// \brief The address held by o: a ctypes or cffi pointer, an integer, or
+  ///        None for NULL.
+  /// \throw std::invalid_argument for other objects.
+  static void* address(boost::python::object o);
+
+  /// Create a SignalWrapper<T, int>, an AsyncSignalWrapper<T, int> or a
+  /// NativeSignalWrapper<T, int>.
+  template <class T>
+  static SignalBase<int>* create(const std::string& name, boost::python::object callable, int flags,
+                                 std::string& error) {
+    if (flags & NATIVE)
+      return createNative<T>(name, callable, flags, error,
+                             std::integral_constant<bool, ValueStorage<T>::fixedSize>());
+    if (!SignalWrapper<T, int>::checkCallable(callable, error)) return NULL;
+    const bool outParameter = (flags & OUT_PARAMETER) != 0;
+    if (outParameter && !ValueStorage<T>::viewable) {
+      error = "the values of the signal are not arrays of double, they cannot be computed in place";
+      return NULL;
+    }
+    if (flags & ASYNCHRONOUS) return new AsyncSignalWrapper<T, int>(name, callable, outParameter);
+    return new SignalWrapper<T, int>(name, callable, outParameter);
+  }
+
+ private:
+  template <class T>
+  static SignalBase<int>* createNative(const std::string&, boost::python::object, int, std::string& error,
+                                       std::false_type) {
+    error = "native functions only compute values which are arrays of double of fixed size";
+    return NULL;
+  }
+
+  template <class T>
+  static SignalBase<int>* createNative(const std::string& name, boost::python::object callable, int flags,
+                                       std::string& error, std::true_type) {
+    if (flags & (OUT_PARAMETER | ASYNCHRONOUS)) {
+      error = "native functions always compute values in place and without the GIL";
+      return NULL;
+    }
+    typedef NativeSignalWrapper<T, int> Native_t;
+    typename Native_t::Function function =
+        reinterpret_cast<typename Native_t::Function>(address(callable[0]));
+    if (function == NULL) {
+      error = "null native function";
+      return NULL;
+    }
+    return new Native_t(name, function, address(callable[1]), callable);
+  }
 };
 
 }  // namespace python
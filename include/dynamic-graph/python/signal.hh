@@ -1,6 +1,7 @@
 // Copyright 2020, Joseph Mirabel, LAAS-CNRS.
 
 #include <sstream>
+#include <type_traits>
 
 #include <boost/python.hpp>
 
@@ -9,21 +10,118 @@
 #include <dynamic-graph/signal-time-dependent.h>
 #include <dynamic-graph/signal.h>
 
+#include "dynamic-graph/python/signal-expression.hh"
 #include "dynamic-graph/python/signal-wrapper.hh"
+#include "dynamic-graph/python/value-access.hh"
 
 namespace dynamicgraph {
 namespace python {
 
+namespace internal {
+/// \brief Return a read-only numpy array sharing the memory of the signal value.
+///
+/// The array keeps the Python signal object alive, not the memory of the
+/// value: it must not be read once the value is recomputed, set or resized,
+/// nor once the signal is destroyed with its entity.
+template <typename T, typename Time>
+boost::python::object signalView(boost::python::object self) {
+  namespace bp = boost::python;
+  const Signal<T, Time>& signal = bp::extract<const Signal<T, Time>&>(self);
+  ArrayLayout layout = ValueStorage<T>::layout(const_cast<T&>(signal.accessCopy()));
+  return bp::object(bp::handle<>(arrayView(layout, false, self.ptr())));
+}
+
+/// \brief Return a writable numpy array sharing the memory of the signal value.
+///
+/// As for signalView, the array does not keep the memory of the value alive:
+/// it must not be written once the value is recomputed, set or resized, nor
+/// once the signal is destroyed with its entity.
+template <typename T, typename Time>
+boost::python::object signalBuffer(boost::python::object self) {
+  namespace bp = boost::python;
+  Signal<T, Time>& signal = bp::extract<Signal<T, Time>&>(self);
+  ArrayLayout layout = ValueStorage<T>::layout(SignalAccess<T, Time>::writableValue(signal));
+  return bp::object(bp::handle<>(arrayView(layout, true, self.ptr())));
+}
+
+/// \brief Copy value into the value of the signal, in place, if the signal
+///        holds its own constant value and value is an array of double of the
+///        shape of this value.
+/// \return whether the value was copied.
+template <typename T, typename Time>
+bool setValueInPlace(Signal<T, Time>& signal, boost::python::object value) {
+  if (!SignalAccess<T, Time>::isOwnConstant(signal)) return false;
+  Buffer buffer(value.ptr());
+  if (!sameShape(buffer, ValueStorage<T>::layout(const_cast<T&>(signal.accessCopy())))) return false;
+  copyArray(buffer, ValueStorage<T>::layout(SignalAccess<T, Time>::writableValue(signal)));
+  return true;
+}
+
+template <typename T, typename Time>
+void setSignalValue(Signal<T, Time>& signal, boost::python::object value) {
+  if (!setValueInPlace(signal, value)) signal.setConstant(boost::python::extract<T>(value)());
+}
+
+template <typename T, typename Time>
+boost::python::object valueSetter(std::false_type) {
+  return boost::python::make_function(&Signal<T, Time>::setConstant);
+}
+
+template <typename T, typename Time>
+boost::python::object valueSetter(std::true_type) {
+  return boost::python::make_function(&setSignalValue<T, Time>);
+}
+
+template <typename T, typename Time, typename Class>
+void addViews(Class&, std::false_type) {}
+
+template <typename T, typename Time>
+void registerValueAccess(std::false_type) {}
+
+template <typename T, typename Time>
+void registerValueAccess(std::true_type) {
+  ValueAccess::add(typeid(T), new ValueAccessTpl<T>);
+}
+
+template <typename T, typename Time, typename Class>
+void addViews(Class& obj, std::true_type) {
+  obj.def("view", &signalView<T, Time>,
+          "Return a read-only numpy array sharing the memory of the signal value.\n"
+          "The array is valid until the signal is recomputed or set: signals\n"
+          "store their value alternately in two buffers. Take a new view after\n"
+          "each update instead of keeping one.\n"
+          "warning: the array does not own its memory. Reading it after the value\n"
+          "of a Vector or Matrix signal changed size, or after the entity of the\n"
+          "signal was destroyed, reads freed memory.");
+  obj.def("buffer", &signalBuffer<T, Time>,
+          "Return a writable numpy array sharing the memory of the signal value,\n"
+          "to modify it in place, e.g. sig.buffer()[0] = 1. or\n"
+          "numpy.add(a, b, out=sig.buffer()).\n"
+          "The signal is made constant, as with setConstant, and marked as\n"
+          "updated. Take a new buffer for each new value.\n"
+          "warning: the array does not own its memory. Writing it after the value\n"
+          "of a Vector or Matrix signal changed size, or after the entity of the\n"
+          "signal was destroyed, writes freed memory.");
+}
+}  // namespace internal
+
 template <typename T, typename Time>
 auto exposeSignal(const std::string& name) {
   namespace bp = boost::python;
 
   typedef Signal<T, Time> S_t;
   bp::class_<S_t, bp::bases<SignalBase<Time> >, boost::noncopyable> obj(name.c_str(), bp::init<std::string>());
+  typedef std::integral_constant<bool, ValueStorage<T>::viewable> viewable;
   obj.add_property("value", bp::make_function(&S_t::accessCopy, bp::return_value_policy<bp::copy_const_reference>()),
-                   &S_t::setConstant,  // TODO check the setter
+                   internal::valueSetter<T, Time>(viewable()),
                    "the signal value.\n"
-                   "warning: for Eigen objects, sig.value[0] = 1. may not work).");
+                   "warning: for Eigen objects, sig.value is a copy hence sig.value[0] = 1.\n"
+                   "does not modify the signal. Use sig.buffer()[0] = 1. instead.\n"
+                   "Arrays of the shape of the current value are copied into it in place.");
+  internal::addViews<T, Time>(obj, viewable());
+  expression::addOperators<T>(obj, std::integral_constant<bool, (expression::Traits<T>::scalar ||
+                                                                 expression::Traits<T>::matrix) &&
+                                                                    std::is_same<Time, int>::value>());
   return obj;
 }
 
@@ -36,6 +134,31 @@ auto exposeSignalWrapper(const std::string& name) {
   return obj;
 }
 
+template <typename T, typename Time>
+auto exposeAsyncSignalWrapper(const std::string& name) {
+  namespace bp = boost::python;
+
+  typedef AsyncSignalWrapper<T, Time> S_t;
+  bp::class_<S_t, bp::bases<Signal<T, Time> >, boost::noncopyable> obj(name.c_str(), bp::no_init);
+  obj.add_property("hasValue", &S_t::hasValue, "whether a value was computed");
+  obj.add_property("valueTime", &S_t::valueTime, "the time at which the current value was requested");
+  obj.add_property("valueAge", &S_t::valueAge,
+                   "the number of seconds elapsed since the current value was computed,\n"
+                   "infinity if there is no value yet");
+  return obj;
+}
+
+namespace internal {
+template <typename T, typename Time>
+void exposeNativeSignalWrapper(const std::string&, std::false_type) {}
+
+template <typename T, typename Time>
+void exposeNativeSignalWrapper(const std::string& name, std::true_type) {
+  namespace bp = boost::python;
+  bp::class_<NativeSignalWrapper<T, Time>, bp::bases<Signal<T, Time> >, boost::noncopyable>(name.c_str(), bp::no_init);
+}
+}  // namespace internal
+
 template <typename T, typename Time>
 auto exposeSignalPtr(const std::string& name) {
   namespace bp = boost::python;
@@ -59,7 +182,12 @@ void exposeSignalsOfType(const std::string& name) {
   exposeSignal<T, Time>("Signal" + name);
   exposeSignalPtr<T, Time>("SignalPtr" + name);
   exposeSignalWrapper<T, Time>("SignalWrapper" + name);
+  exposeAsyncSignalWrapper<T, Time>("AsyncSignalWrapper" + name);
+  internal::exposeNativeSignalWrapper<T, Time>("NativeSignalWrapper" + name,
+                                               std::integral_constant<bool, ValueStorage<T>::fixedSize>());
   exposeSignalTimeDependent<T, Time>("SignalTimeDependent" + name);
+  internal::registerValueAccess<T, Time>(
+      std::integral_constant<bool, ValueStorage<T>::viewable && std::is_same<Time, int>::value>());
 }
 
 }  // namespace python
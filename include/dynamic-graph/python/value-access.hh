@@ -0,0 +1,91 @@
+// -*- mode: c++ -*-
+// Copyright 2026, CNRS.
+
+#ifndef DYNAMIC_GRAPH_PYTHON_VALUE_ACCESS_HH
+#define DYNAMIC_GRAPH_PYTHON_VALUE_ACCESS_HH
+
+#include <typeinfo>
+
+#include <dynamic-graph/signal-base.h>
+#include <dynamic-graph/signal-ptr.h>
+#include <dynamic-graph/signal.h>
+
+#include "dynamic-graph/python/api.hh"
+#include "dynamic-graph/python/value-storage.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+namespace internal {
+/// Access to the protected members of Signal.
+template <typename T, typename Time>
+struct SignalAccess : Signal<T, Time> {
+  /// Whether the signal holds its own constant value, which can then be
+  /// modified in place. Unplugged SignalPtr have no value.
+  static bool isOwnConstant(const Signal<T, Time>& signal) {
+    if (signal.*(&SignalAccess::signalType) != SignalAccess::CONSTANT) return false;
+    if (signal.isPlugged()) return signal.getPluged() == &signal;
+    return dynamic_cast<const SignalPtr<T, Time>*>(&signal) == NULL;
+  }
+
+  /// \brief Return the value of the signal, to be modified in place.
+  ///
+  /// Signals which are not constant, or plugged into another signal, are
+  /// first made constant with their current value. The signal is marked as
+  /// updated.
+  static T& writableValue(Signal<T, Time>& signal) {
+    if (!isOwnConstant(signal)) signal.setConstant(signal.accessCopy());
+    signal.setReady();
+    return const_cast<T&>(signal.accessCopy());
+  }
+};
+}  // namespace internal
+
+/// \brief Access to the values of the signals of a type, as arrays of double,
+///        without knowing the type at compile time.
+///
+/// An instance is registered by exposeSignalsOfType for each type whose
+/// values are stored as arrays of double (see ValueStorage).
+class DYNAMIC_GRAPH_PYTHON_DLLAPI ValueAccess {
+ public:
+  virtual ~ValueAccess() {}
+
+  /// Whether signal is a Signal of the type handled by this object.
+  virtual bool handles(const SignalBase<int>& signal) const = 0;
+  /// Whether all the values of the type have the same size.
+  virtual bool fixedSize() const = 0;
+  /// The memory of the current value of the signal.
+  virtual ArrayLayout layout(SignalBase<int>& signal) const = 0;
+  /// \brief The memory of the value of the signal, to be modified in place.
+  /// The signal is made constant if needed and marked as updated.
+  virtual ArrayLayout writableLayout(SignalBase<int>& signal) const = 0;
+
+  /// \brief Register the access to the signals of a type.
+  /// Takes the ownership of access, unless the type is already registered.
+  static void add(const std::type_info& type, ValueAccess* access);
+  /// \return the access to the value of the signal, or NULL if its type is
+  ///         not registered.
+  static const ValueAccess* find(const SignalBase<int>& signal);
+};
+
+template <typename T>
+class ValueAccessTpl : public ValueAccess {
+ public:
+  typedef Signal<T, int> Signal_t;
+
+  virtual bool handles(const SignalBase<int>& signal) const {
+    return dynamic_cast<const Signal_t*>(&signal) != NULL;
+  }
+  virtual bool fixedSize() const { return ValueStorage<T>::fixedSize; }
+  virtual ArrayLayout layout(SignalBase<int>& signal) const {
+    return ValueStorage<T>::layout(const_cast<T&>(static_cast<Signal_t&>(signal).accessCopy()));
+  }
+  virtual ArrayLayout writableLayout(SignalBase<int>& signal) const {
+    return ValueStorage<T>::layout(internal::SignalAccess<T, int>::writableValue(static_cast<Signal_t&>(signal)));
+  }
+};
+
+}  // namespace python
+}  // namespace dynamicgraph
+
+#endif  // DYNAMIC_GRAPH_PYTHON_VALUE_ACCESS_HH
@@ -0,0 +1,79 @@
+// -*- mode: c++ -*-
+// Copyright 2026, CNRS.
+
+#ifndef DYNAMIC_GRAPH_PYTHON_VALUE_STORAGE_HH
+#define DYNAMIC_GRAPH_PYTHON_VALUE_STORAGE_HH
+
+#include <Eigen/Geometry>
+
+#include "dynamic-graph/python/buffer.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+/// \brief Describe how values of type T are stored as an array of double.
+///
+/// Specialized for the types whose memory can be shared with numpy:
+/// double, Eigen matrices of double, transforms (their matrix) and
+/// quaternions (their coefficients x, y, z, w).
+template <typename T, typename Enable = void>
+struct ValueStorage {
+  static const bool viewable = false;
+  static const bool fixedSize = false;
+};
+
+template <>
+struct ValueStorage<double> {
+  static const bool viewable = true;
+  static const bool fixedSize = true;
+
+  static ArrayLayout layout(double& value) {
+    ArrayLayout res = {&value, 0, {1, 1}, {sizeof(double), sizeof(double)}};
+    return res;
+  }
+};
+
+template <int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct ValueStorage<Eigen::Matrix<double, Rows, Cols, Options, MaxRows, MaxCols> > {
+  typedef Eigen::Matrix<double, Rows, Cols, Options, MaxRows, MaxCols> T;
+  static const bool viewable = true;
+  static const bool fixedSize = (Rows != Eigen::Dynamic && Cols != Eigen::Dynamic);
+
+  /// Column vectors are seen as one-dimensional arrays.
+  static ArrayLayout layout(T& value) {
+    const Py_ssize_t itemsize = sizeof(double);
+    ArrayLayout res = {value.data(), (Cols == 1 ? 1 : 2), {value.rows(), value.cols()}, {itemsize, itemsize}};
+    if (Cols != 1) {
+      if (T::IsRowMajor)
+        res.strides[0] = itemsize * value.cols();
+      else
+        res.strides[1] = itemsize * value.rows();
+    }
+    return res;
+  }
+};
+
+template <int Dim, int Mode, int Options>
+struct ValueStorage<Eigen::Transform<double, Dim, Mode, Options> > {
+  typedef Eigen::Transform<double, Dim, Mode, Options> T;
+  typedef ValueStorage<typename T::MatrixType> Matrix_t;
+  static const bool viewable = true;
+  static const bool fixedSize = true;
+
+  static ArrayLayout layout(T& value) { return Matrix_t::layout(value.matrix()); }
+};
+
+template <int Options>
+struct ValueStorage<Eigen::Quaternion<double, Options> > {
+  typedef Eigen::Quaternion<double, Options> T;
+  typedef ValueStorage<typename T::Coefficients> Coefficients_t;
+  static const bool viewable = true;
+  static const bool fixedSize = true;
+
+  static ArrayLayout layout(T& value) { return Coefficients_t::layout(value.coeffs()); }
+};
+
+}  // namespace python
+}  // namespace dynamicgraph
+
+#endif  // DYNAMIC_GRAPH_PYTHON_VALUE_STORAGE_HH
@@ -0,0 +1,107 @@
+// -*- mode: c++ -*-
+// Copyright 2026, CNRS.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include "dynamic-graph/python/async-interpreter.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+// As submitting a command must not take a lock, a notification may be missed
+// if it happens while the interpreter thread is about to sleep. The thread
+// therefore never sleeps longer than this.
+static const std::chrono::milliseconds maxSleepDuration(10);
+
+AsyncInterpreter::AsyncInterpreter(Interpreter& interpreter)
+    : interpreter_(interpreter), head_(&stub_), tail_(&stub_), stop_(false) {
+  stub_.next.store(NULL);
+  thread_ = std::thread(&AsyncInterpreter::run, this);
+}
+
+AsyncInterpreter::~AsyncInterpreter() {
+  stop_.store(true);
+  wakeUp_.notify_one();
+  thread_.join();
+}
+
+std::future<CommandResult> AsyncInterpreter::submit(const std::string& command) {
+  std::shared_ptr<std::promise<CommandResult> > promise(new std::promise<CommandResult>);
+  submit(command, [promise](const CommandResult& result) { promise->set_value(result); });
+  return promise->get_future();
+}
+
+void AsyncInterpreter::submit(const std::string& command, const Callback_t& callback) {
+  Node* node = new Node;
+  node->command = command;
+  node->callback = callback;
+  push(node);
+  wakeUp_.notify_one();
+}
+
+void AsyncInterpreter::post(const std::string& command) { submit(command, Callback_t()); }
+
+void AsyncInterpreter::push(Node* node) {
+  node->next.store(NULL, std::memory_order_relaxed);
+  Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+  prev->next.store(node, std::memory_order_release);
+}
+
+AsyncInterpreter::Node* AsyncInterpreter::pop() {
+  Node* tail = tail_;
+  Node* next = tail->next.load(std::memory_order_acquire);
+  if (tail == &stub_) {
+    if (next == NULL) return NULL;
+    tail_ = next;
+    tail = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+  if (next != NULL) {
+    tail_ = next;
+    return tail;
+  }
+  // Either tail is the last node or a producer has not linked its node yet.
+  if (tail != head_.load(std::memory_order_acquire)) return NULL;
+  push(&stub_);
+  next = tail->next.load(std::memory_order_acquire);
+  if (next != NULL) {
+    tail_ = next;
+    return tail;
+  }
+  return NULL;
+}
+
+void AsyncInterpreter::run() {
+  // Keep a Python thread state for this thread while it runs, so that the
+  // interpreter does not create one for each command.
+  PyGILState_STATE gilState = PyGILState_Ensure();
+  PyThreadState* threadState = PyEval_SaveThread();
+  while (true) {
+    Node* node = pop();
+    if (node == NULL) {
+      // Pending commands are executed before stopping.
+      if (stop_.load() && head_.load() == tail_) break;
+      std::unique_lock<std::mutex> lock(mutex_);
+      wakeUp_.wait_for(lock, maxSleepDuration);
+      continue;
+    }
+    CommandResult result;
+    interpreter_.python(node->command, result.result, result.out, result.err);
+    if (node->callback) {
+      try {
+        node->callback(result);
+      } catch (const std::exception& exc) {
+        std::cerr << "AsyncInterpreter: callback of command " << node->command << " failed: " << exc.what()
+                  << std::endl;
+      }
+    }
+    delete node;
+  }
+  PyEval_RestoreThread(threadState);
+  PyGILState_Release(gilState);
+}
+
+}  // namespace python
+}  // namespace dynamicgraph
@@ -0,0 +1,207 @@
+// Copyright 2026, CNRS.
+
+#include <cstring>
+
+#include "dynamic-graph/python/buffer.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+namespace {
+bool isDoubleFormat(const char* format) {
+  if (format == NULL) return false;
+  // Native or standard byte order only.
+  if (format[0] == '@' || format[0] == '=') ++format;
+  return std::strcmp(format, "d") == 0;
+}
+}  // namespace
+
+Buffer::Buffer(PyObject* o, bool writable)
+    : acquired_(false), valid_(false), rows_(0), cols_(0), innerStride_(1), outerStride_(1) {
+  int flags = PyBUF_STRIDES | PyBUF_FORMAT;
+  if (writable) flags |= PyBUF_WRITABLE;
+  if (!PyObject_CheckBuffer(o) || PyObject_GetBuffer(o, &view_, flags) != 0) {
+    PyErr_Clear();
+    return;
+  }
+  acquired_ = true;
+
+  if (view_.itemsize != sizeof(double) || !isDoubleFormat(view_.format) || view_.ndim > 2) return;
+  Py_ssize_t strides[2] = {1, 1};
+  for (int i = 0; i < view_.ndim; ++i) {
+    // Negative or unaligned strides are not supported.
+    if (view_.strides[i] < 0 || view_.strides[i] % Py_ssize_t(sizeof(double)) != 0) return;
+    strides[i] = view_.strides[i] / Py_ssize_t(sizeof(double));
+  }
+  switch (view_.ndim) {
+    case 0:
+      rows_ = cols_ = 1;
+      break;
+    case 1:
+      rows_ = view_.shape[0];
+      cols_ = 1;
+      innerStride_ = strides[0];
+      outerStride_ = rows_ * innerStride_;
+      break;
+    case 2:
+      rows_ = view_.shape[0];
+      cols_ = view_.shape[1];
+      innerStride_ = strides[0];
+      outerStride_ = strides[1];
+      break;
+  }
+  valid_ = true;
+}
+
+Buffer::~Buffer() {
+  if (acquired_) PyBuffer_Release(&view_);
+}
+
+namespace {
+inline double& element(const ArrayLayout& layout, Py_ssize_t i, Py_ssize_t j) {
+  return *reinterpret_cast<double*>(reinterpret_cast<char*>(layout.data) + i * layout.strides[0] +
+                                    j * layout.strides[1]);
+}
+
+// Whether the elements are contiguous in row-major order.
+bool isRowMajor(const ArrayLayout& layout) {
+  const Py_ssize_t itemsize = sizeof(double);
+  switch (layout.ndim) {
+    case 0:
+      return true;
+    case 1:
+      return layout.shape[0] < 2 || layout.strides[0] == itemsize;
+    default:
+      return (layout.shape[1] < 2 || layout.strides[1] == itemsize) &&
+             (layout.shape[0] < 2 || layout.strides[0] == itemsize * layout.shape[1]);
+  }
+}
+}  // namespace
+
+void ArrayLayout::copyTo(double* dst) const {
+  if (isRowMajor(*this)) {
+    std::memcpy(dst, data, size() * sizeof(double));
+  } else if (ndim == 1) {
+    for (Py_ssize_t i = 0; i < shape[0]; ++i) dst[i] = element(*this, i, 0);
+  } else {
+    for (Py_ssize_t i = 0; i < shape[0]; ++i)
+      for (Py_ssize_t j = 0; j < shape[1]; ++j) *dst++ = element(*this, i, j);
+  }
+}
+
+void ArrayLayout::copyFrom(const double* src) const {
+  if (isRowMajor(*this)) {
+    std::memcpy(data, src, size() * sizeof(double));
+  } else if (ndim == 1) {
+    for (Py_ssize_t i = 0; i < shape[0]; ++i) element(*this, i, 0) = src[i];
+  } else {
+    for (Py_ssize_t i = 0; i < shape[0]; ++i)
+      for (Py_ssize_t j = 0; j < shape[1]; ++j) element(*this, i, j) = *src++;
+  }
+}
+
+bool sameShape(const Buffer& buffer, const ArrayLayout& layout) {
+  return buffer.valid() && buffer.ndim() == layout.ndim && buffer.size() == layout.size() &&
+         buffer.rows() == (layout.ndim > 0 ? layout.shape[0] : 1);
+}
+
+void copyArray(const Buffer& buffer, const ArrayLayout& layout) {
+  Buffer::Map_t src = buffer.map(), dst = layout.map();
+  if (src.size() == 0) return;
+  const double* srcEnd = &src(src.rows() - 1, src.cols() - 1) + 1;
+  const double* dstEnd = &dst(dst.rows() - 1, dst.cols() - 1) + 1;
+  // e.g. when setting a value computed from a view of the same value.
+  if (src.data() < dstEnd && dst.data() < srcEnd)
+    dst = src.eval();
+  else
+    dst = src;
+}
+
+namespace {
+/// Exposes memory described by an ArrayLayout through the buffer protocol.
+struct ArrayExporter {
+  PyObject_HEAD
+  ArrayLayout layout;
+  int readonly;
+  PyObject* owner;
+};
+
+void ArrayExporter_dealloc(PyObject* self) {
+  Py_XDECREF(reinterpret_cast<ArrayExporter*>(self)->owner);
+  Py_TYPE(self)->tp_free(self);
+}
+
+int ArrayExporter_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+  ArrayExporter& exporter = *reinterpret_cast<ArrayExporter*>(self);
+  const ArrayLayout& layout = exporter.layout;
+  if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE && exporter.readonly) {
+    PyErr_SetString(PyExc_BufferError, "the array is read-only");
+    return -1;
+  }
+  // Only matrices stored in row-major order are C-contiguous.
+  if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES && layout.ndim == 2 && layout.shape[0] > 1 &&
+      layout.strides[0] < layout.strides[1]) {
+    PyErr_SetString(PyExc_BufferError, "the array is not C-contiguous");
+    return -1;
+  }
+  view->buf = layout.data;
+  view->obj = self;
+  Py_INCREF(self);
+  view->len = layout.size() * Py_ssize_t(sizeof(double));
+  view->readonly = exporter.readonly;
+  view->itemsize = sizeof(double);
+  view->format = ((flags & PyBUF_FORMAT) == PyBUF_FORMAT ? const_cast<char*>("d") : NULL);
+  view->ndim = layout.ndim;
+  view->shape = ((flags & PyBUF_ND) == PyBUF_ND ? const_cast<Py_ssize_t*>(layout.shape) : NULL);
+  view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES ? const_cast<Py_ssize_t*>(layout.strides) : NULL);
+  view->suboffsets = NULL;
+  view->internal = NULL;
+  return 0;
+}
+
+PyTypeObject* arrayExporterType() {
+  static PyBufferProcs bufferProcs;
+  static PyTypeObject type = {PyVarObject_HEAD_INIT(NULL, 0)};
+  if (type.tp_name == NULL) {
+    bufferProcs.bf_getbuffer = ArrayExporter_getbuffer;
+    type.tp_name = "dynamic_graph.ArrayExporter";
+    type.tp_basicsize = sizeof(ArrayExporter);
+    type.tp_flags = Py_TPFLAGS_DEFAULT;
+#if PY_MAJOR_VERSION < 3
+    type.tp_flags |= Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
+    type.tp_doc = "Expose memory owned by C++ objects through the buffer protocol.";
+    type.tp_as_buffer = &bufferProcs;
+    type.tp_dealloc = ArrayExporter_dealloc;
+    if (PyType_Ready(&type) < 0) return NULL;
+  }
+  return &type;
+}
+}  // namespace
+
+PyObject* arrayView(const ArrayLayout& layout, bool writable, PyObject* owner) {
+  static PyObject* asarray = NULL;
+  if (asarray == NULL) {
+    PyObject* numpy = PyImport_ImportModule("numpy");
+    if (numpy == NULL) return NULL;
+    asarray = PyObject_GetAttrString(numpy, "asarray");
+    Py_DECREF(numpy);
+    if (asarray == NULL) return NULL;
+  }
+  PyTypeObject* type = arrayExporterType();
+  if (type == NULL) return NULL;
+
+  ArrayExporter* exporter = PyObject_New(ArrayExporter, type);
+  if (exporter == NULL) return NULL;
+  exporter->layout = layout;
+  exporter->readonly = !writable;
+  exporter->owner = owner;
+  Py_XINCREF(owner);
+  // The array keeps the exporter, hence the owner, alive.
+  PyObject* res = PyObject_CallFunctionObjArgs(asarray, exporter, NULL);
+  Py_DECREF(exporter);
+  return res;
+}
+
+}  // namespace python
+}  // namespace dynamicgraph
@@ -1,6 +1,7 @@
 // Copyright 2010, Florent Lamiraux, Thomas Moulard, LAAS-CNRS.
 
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 #include <boost/python.hpp>
@@ -10,6 +11,7 @@
 #include <dynamic-graph/signal.h>
 #include <dynamic-graph/signal-caster.h>
 
+#include "dynamic-graph/python/buffer.hh"
 #include "dynamic-graph/python/convert-dg-to-py.hh"
 #include "dynamic-graph/python/python-compat.hh"
 
@@ -22,6 +24,65 @@ namespace convert {
 
 namespace bp = boost::python;
 
+namespace {
+/// \brief Copy the elements of a list or tuple of numbers into res.
+/// \return false if o is not a list or tuple of numbers.
+bool sequenceToVector(PyObject* o, Vector& res) {
+  if (!PyList_Check(o) && !PyTuple_Check(o)) return false;
+  const Py_ssize_t n = PySequence_Fast_GET_SIZE(o);
+  res.resize(n);
+  for (Py_ssize_t i = 0; i < n; ++i) {
+    res[i] = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(o, i));
+    if (res[i] == -1. && PyErr_Occurred()) {
+      PyErr_Clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \brief Convert o, a one-dimensional buffer of double or a list or tuple of
+///        numbers, into a vector.
+/// \return false if o is none of them.
+bool toVector(PyObject* o, Vector& res) {
+  Buffer buffer(o);
+  if (!buffer.valid()) return sequenceToVector(o, res);
+  if (buffer.ndim() != 1) return false;
+  res = buffer.map().col(0);
+  return true;
+}
+
+/// \brief Convert o, a two-dimensional buffer of double or a list or tuple of
+///        rows of numbers, into a matrix of the shape of res if it is fixed.
+/// \return false if o is none of them.
+template <typename MatrixType>
+bool toMatrix(PyObject* o, MatrixType& res) {
+  Buffer buffer(o);
+  if (buffer.valid()) {
+    if (buffer.ndim() != 2 || (MatrixType::RowsAtCompileTime != Eigen::Dynamic &&
+                                (buffer.rows() != res.rows() || buffer.cols() != res.cols())))
+      return false;
+    res = buffer.map();
+    return true;
+  }
+  if (!PyList_Check(o) && !PyTuple_Check(o)) return false;
+  const Py_ssize_t rows = PySequence_Fast_GET_SIZE(o);
+  Vector row;
+  for (Py_ssize_t i = 0; i < rows; ++i) {
+    if (!sequenceToVector(PySequence_Fast_GET_ITEM(o, i), row)) return false;
+    if (i == 0) {
+      if (MatrixType::RowsAtCompileTime != Eigen::Dynamic && (rows != res.rows() || row.size() != res.cols()))
+        return false;
+      res.resize(rows, row.size());
+    } else if (row.size() != res.cols()) {
+      return false;
+    }
+    res.row(i) = row.transpose();
+  }
+  return rows > 0;
+}
+}  // namespace
+
 command::Value toValue(bp::object o, const command::Value::Type& valueType) {
   using command::Value;
   switch (valueType) {
@@ -37,26 +98,157 @@ command::Value toValue(bp::object o, const command::Value::Type& valueType) {
       return Value(bp::extract<double>(o));
     case (Value::STRING):
       return Value(bp::extract<std::string>(o));
+    // Buffers of double and lists of numbers are copied without temporary
+    // Python or eigenpy objects. Other objects, e.g. arrays of integers, are
+    // converted by eigenpy, which reports the errors.
+    case (Value::VECTOR): {
+      Vector vector;
+      if (toVector(o.ptr(), vector)) return Value(vector);
+      return Value(bp::extract<Vector>(o)());
+    }
+    case (Value::MATRIX): {
+      Matrix matrix;
+      if (toMatrix(o.ptr(), matrix)) return Value(matrix);
+      return Value(bp::extract<Matrix>(o)());
+    }
+    case (Value::MATRIX4D): {
+      Eigen::Matrix4d matrix;
+      if (toMatrix(o.ptr(), matrix)) return Value(matrix);
+      return Value(bp::extract<Eigen::Matrix4d>(o)());
+    }
+    case (Value::VALUES):
+      // The types of the elements are inferred from their Python types.
+      if (!PyList_Check(o.ptr()) && !PyTuple_Check(o.ptr()))
+        throw std::invalid_argument("expected a list or a tuple, got " + obj_to_str(o.ptr()));
+      return toValue(o);
+    default:
+      std::cerr << "Only int, double and string are supported." << std::endl;
+  }
+  return Value();
+}
+
+namespace {
+template <command::Value::Type type>
+command::Value generic(PyObject* o) {
+  return toValue(bp::object(bp::handle<>(bp::borrowed(o))), type);
+}
+
+command::Value toBool(PyObject* o) {
+  if (PyBool_Check(o)) return command::Value(o == Py_True);
+  return generic<command::Value::BOOL>(o);
+}
+
+/// Integers out of the range of T are converted by generic, which raises
+/// OverflowError.
+template <typename T, command::Value::Type type>
+command::Value toInteger(PyObject* o) {
+  if (PyLong_Check(o)) {
+    int overflow;
+    const long long value = PyLong_AsLongLongAndOverflow(o, &overflow);
+    if (overflow == 0 && !(value == -1 && PyErr_Occurred()) && value >= std::numeric_limits<T>::min() &&
+        value <= static_cast<long long>(std::numeric_limits<T>::max()))
+      return command::Value(static_cast<T>(value));
+    PyErr_Clear();
+  }
+  return generic<type>(o);
+}
+
+template <typename T, command::Value::Type type>
+command::Value toFloating(PyObject* o) {
+  if (PyFloat_Check(o)) return command::Value(static_cast<T>(PyFloat_AS_DOUBLE(o)));
+  if (PyLong_Check(o)) {
+    const double value = PyLong_AsDouble(o);
+    if (!(value == -1. && PyErr_Occurred())) return command::Value(static_cast<T>(value));
+    PyErr_Clear();
+  }
+  return generic<type>(o);
+}
+
+/// Value has no integer type wider than int and unsigned: larger integers are
+/// converted to DOUBLE, as by toFloating.
+command::Value inferInteger(PyObject* o) {
+  int overflow;
+  const long long value = PyLong_AsLongLongAndOverflow(o, &overflow);
+  if (overflow == 0 && !(value == -1 && PyErr_Occurred())) {
+    if (value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max())
+      return command::Value(static_cast<int>(value));
+    if (value >= 0 && value <= static_cast<long long>(std::numeric_limits<unsigned>::max()))
+      return command::Value(static_cast<unsigned>(value));
+  }
+  PyErr_Clear();
+  return toFloating<double, command::Value::DOUBLE>(o);
+}
+
+command::Value toString(PyObject* o) {
+#if PY_MAJOR_VERSION >= 3
+  if (PyUnicode_Check(o)) {
+    Py_ssize_t size;
+    const char* data = PyUnicode_AsUTF8AndSize(o, &size);
+    if (data != NULL) return command::Value(std::string(data, size));
+    PyErr_Clear();
+  }
+#endif
+  return generic<command::Value::STRING>(o);
+}
+}  // namespace
+
+ValueConverter valueConverter(const command::Value::Type& type) {
+  using command::Value;
+  switch (type) {
+    case (Value::BOOL):
+      return &toBool;
+    case (Value::UNSIGNED):
+      return &toInteger<unsigned, Value::UNSIGNED>;
+    case (Value::INT):
+      return &toInteger<int, Value::INT>;
+    case (Value::FLOAT):
+      return &toFloating<float, Value::FLOAT>;
+    case (Value::DOUBLE):
+      return &toFloating<double, Value::DOUBLE>;
+    case (Value::STRING):
+      return &toString;
     case (Value::VECTOR):
-      // TODO for backward compatibility, support tuple or list ?
-      // I don't think so
-      return Value(bp::extract<Vector>(o));
+      return &generic<Value::VECTOR>;
     case (Value::MATRIX):
-      // TODO for backward compatibility, support tuple or list ?
-      // I don't think so
-      return Value(bp::extract<Matrix>(o));
+      return &generic<Value::MATRIX>;
     case (Value::MATRIX4D):
-      return Value(bp::extract<Eigen::Matrix4d>(o));
+      return &generic<Value::MATRIX4D>;
     case (Value::VALUES):
-      // TODO the vector of values cannot be built since
-      // - the value type inside the vector are not know
-      // - inferring the value type from the Python type is not implemented.
-      throw std::invalid_argument("not implemented: cannot create a vector of values");
-      break;
+      return &generic<Value::VALUES>;
     default:
-      std::cerr << "Only int, double and string are supported." << std::endl;
+      return &generic<Value::NONE>;
   }
-  return Value();
+}
+
+command::Value toValue(bp::object o) {
+  using command::Value;
+  PyObject* po = o.ptr();
+  if (po == Py_None) return Value();
+  // bool must be checked before int, as it is a subclass of int.
+  if (PyBool_Check(po)) return Value(bp::extract<bool>(o)());
+#if PY_MAJOR_VERSION < 3
+  if (PyInt_Check(po)) return Value(bp::extract<int>(o)());
+#endif
+  if (PyLong_Check(po)) return inferInteger(po);
+  if (PyFloat_Check(po)) return Value(bp::extract<double>(o)());
+  if (PyUnicode_Check(po)) return Value(bp::extract<std::string>(o)());
+#if PY_MAJOR_VERSION < 3
+  if (PyString_Check(po)) return Value(bp::extract<std::string>(o)());
+#endif
+  if (PyList_Check(po) || PyTuple_Check(po)) {
+    command::Values values;
+    values.reserve(bp::len(o));
+    for (bp::stl_input_iterator<bp::object> it(o), end; it != end; ++it) values.push_back(toValue(*it));
+    return Value(values);
+  }
+  {
+    Buffer buffer(po);
+    if (buffer.valid()) {
+      if (buffer.ndim() == 1) return Value(Vector(buffer.map().col(0)));
+      if (buffer.ndim() == 2) return Value(Matrix(buffer.map()));
+    }
+  }
+  throw std::invalid_argument("cannot infer the value type of " + obj_to_str(po));
 }
 
 bp::object fromValue(const command::Value& value) {
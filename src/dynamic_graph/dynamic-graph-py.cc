@@ -190,6 +190,12 @@ void exposeCommand() {
   using dg::command::Command;
   bp::class_<Command, boost::noncopyable>("Command", bp::no_init)
       .def("__call__", bp::raw_function(dg::python::entity::executeCmd, 1), "execute the command")
+      .add_property("threadSafe", dg::python::entity::isThreadSafe, dg::python::entity::setThreadSafe,
+                    "whether execute_batch may execute the command without the GIL.\n"
+                    "Shared by the commands of this name of all the entities of the class.\n"
+                    "Only set it for commands which do not use Python. The commands\n"
+                    "keep their arguments between calls: while a batch runs, other\n"
+                    "Python threads must not call them nor modify their entities.")
       .add_property("__doc__", &Command::getDocstring);
 }
 
@@ -198,11 +204,40 @@ void exposeOldAPI() {
           (bp::arg("signalOut"), "signalIn"));
   bp::def("enableTrace", dynamicgraph::python::enableTrace, "Enable or disable tracing debug info in a file");
   // Signals
-  bp::def("create_signal_wrapper", dynamicgraph::python::signalBase::createSignalWrapper, reference_existing_object(),
-          "create a SignalWrapper C++ object");
+  bp::def("create_signal_wrapper", dynamicgraph::python::signalBase::createSignalWrapper,
+          (bp::arg("name"), "type", "callable", bp::arg("out") = false, bp::arg("asynchronous") = false,
+           bp::arg("user") = bp::object()),
+          reference_existing_object(),
+          "create a SignalWrapper C++ object.\n"
+          "The value at time t is callable(t). If out is True, callable(t, out) is\n"
+          "called instead, with out a writable numpy array sharing the memory of\n"
+          "the value, to fill in place. It must not be kept. For types of variable\n"
+          "size, out has the shape of the previous value: callable may return a\n"
+          "value instead of None to set the first value or change its shape.\n"
+          "If asynchronous is True, callable is called in a dedicated thread and\n"
+          "recomputing the signal returns the latest value computed, without\n"
+          "waiting nor taking the GIL. See the properties hasValue, valueTime and\n"
+          "valueAge of the signal.\n"
+          "callable may also be a native function, as a ctypes or cffi function\n"
+          "pointer of signature void(double* out, int t, void* user), called\n"
+          "without the GIL with out the elements of the value, in the order in\n"
+          "which they are stored: column-major for matrices, x, y, z, w for\n"
+          "quaternions. Only for types of fixed size. user is given to the\n"
+          "function: a ctypes or cffi pointer, an integer address or None.");
+  bp::def("signal_wrapper_types", dynamicgraph::python::signalBase::getSignalWrapperTypes,
+          "return the list of types accepted by create_signal_wrapper");
   // Entity
   bp::def("factory_get_entity_class_list", dynamicgraph::python::factory::getEntityClassList,
           "return the list of entity classes");
+  bp::def("execute_batch", dynamicgraph::python::entity::executeBatch, bp::arg("commands"),
+          "execute commands given as (entity name, command name, arguments).\n"
+          "All the commands are found and their arguments converted before the\n"
+          "first one is executed. Failures do not stop the batch. The GIL is\n"
+          "released while executing the commands whose threadSafe is True, so\n"
+          "other Python threads must not call these commands, nor modify their\n"
+          "entities, until execute_batch returns.\n"
+          "Return the list of the results, None for the commands which failed,\n"
+          "and the list of (index, error message) of the commands which failed.");
   bp::def("writeGraph", dynamicgraph::python::pool::writeGraph, "Write the graph of entities in a filename.");
   bp::def("get_entity_list", dynamicgraph::python::pool::getEntityList, "return the list of instanciated entities");
   bp::def("addLoggerFileOutputStream", dynamicgraph::python::debug::addLoggerFileOutputStream,
@@ -234,6 +269,13 @@ BOOST_PYTHON_MODULE(wrap) {
   exposeOldAPI();
 
   dg::python::exposeSignals();
+  dg::python::signalBase::registerSignalWrapperTypes();
+  dg::python::signalExpression::expose();
+  dg::python::signalGroup::expose();
+  dg::python::signalHistory::expose();
+  // The threads of the asynchronous signal wrappers take the GIL: stop them
+  // before the interpreter is finalized.
+  bp::import("atexit").attr("register")(bp::make_function(&dg::python::AsyncSignalThread::stopAll));
   exposeEntityBase();
   exposeCommand();
 
@@ -1,6 +1,13 @@
 // Copyright 2010, Florent Lamiraux, Thomas Moulard, LAAS-CNRS.
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 #include <dynamic-graph/entity.h>
 #include <dynamic-graph/factory.h>
@@ -12,6 +19,7 @@
 
 #include "dynamic-graph/python/convert-dg-to-py.hh"
 #include "dynamic-graph/python/dynamic-graph-py.hh"
+#include "dynamic-graph/python/python-compat.hh"
 
 // Ignore "dereferencing type-punned pointer will break strict-aliasing rules"
 // warnings on gcc caused by Py_RETURN_TRUE and Py_RETURN_FALSE.
@@ -23,6 +31,7 @@ namespace bp = boost::python;
 
 using dynamicgraph::Entity;
 using dynamicgraph::Matrix;
+using dynamicgraph::PoolStorage;
 using dynamicgraph::SignalBase;
 using dynamicgraph::Vector;
 using dynamicgraph::command::Command;
@@ -72,15 +81,193 @@ Entity* create(const char* className, const char* instanceName) {
   return obj;
 }
 
+namespace {
+/// \brief The conversions of the arguments of a command, set up at its first
+///        call, and the vector of the arguments reused by the next calls.
+///
+/// Reusing the vector only saves its allocation: a Value still allocates its
+/// content when it is constructed and assigned, and setParameterValues copies
+/// the values into the command.
+struct Dispatch {
+  std::vector<Value::Type> types;
+  std::vector<convert::ValueConverter> converters;
+  std::vector<Value> values;
+};
+
+typedef std::unordered_map<const Command*, Dispatch> Dispatches;
+
+/// Remove the entries of the commands which are not commands of an entity of
+/// the pool anymore.
+void evictDestroyed(Dispatches& dispatches) {
+  std::unordered_set<const Command*> commands;
+  for (const auto& entity : PoolStorage::getInstance()->getEntityMap())
+    for (const auto& command : entity.second->getNewStyleCommandMap()) commands.insert(command.second);
+  for (Dispatches::iterator it = dispatches.begin(); it != dispatches.end();)
+    it = (commands.count(it->first) > 0 ? std::next(it) : dispatches.erase(it));
+}
+
+/// Must be called with the GIL held.
+Dispatch& dispatch(const Command& command) {
+  static Dispatches dispatches;
+  // The destroyed commands are evicted each time the number of entries doubled.
+  static std::size_t evictionSize = 64;
+  Dispatches::iterator it = dispatches.find(&command);
+  if (it == dispatches.end()) {
+    if (dispatches.size() >= evictionSize) {
+      evictDestroyed(dispatches);
+      evictionSize = std::max<std::size_t>(64, 2 * dispatches.size());
+    }
+    it = dispatches.emplace(&command, Dispatch()).first;
+  }
+  Dispatch& res = it->second;
+  // Also rebuilt if a command was destroyed and another one allocated at the
+  // same address before its entry was evicted.
+  if (res.converters.size() != command.valueTypes().size() || res.types != command.valueTypes()) {
+    res.types = command.valueTypes();
+    res.converters.clear();
+    for (const Value::Type& type : res.types) res.converters.push_back(convert::valueConverter(type));
+    res.values.assign(res.types.size(), Value());
+  }
+  return res;
+}
+
+/// \brief The (entity class name, command name) of the commands which may be
+///        executed without the GIL.
+///
+/// Keyed by names rather than by command, as being thread-safe is a property
+/// of the implementation of a command, shared by the entities of a class, and
+/// so that it is not inherited by a command allocated where a destroyed one was.
+/// Must be used with the GIL held.
+std::set<std::pair<std::string, std::string> >& threadSafeCommands() {
+  static std::set<std::pair<std::string, std::string> > res;
+  return res;
+}
+
+/// The (entity class name, command name) of a command.
+std::pair<std::string, std::string> commandKey(Command& command) {
+  Entity& owner = command.owner();
+  for (const auto& el : owner.getNewStyleCommandMap())
+    if (el.second == &command) return std::make_pair(owner.getClassName(), el.first);
+  throw std::invalid_argument("the command is not a command of entity " + owner.getName());
+}
+
+/// Return the message of the current Python error, and clear it.
+std::string fetchPythonError() {
+  PyObject *type, *value, *traceback;
+  PyErr_Fetch(&type, &value, &traceback);
+  PyErr_NormalizeException(&type, &value, &traceback);
+  std::string res = (value != NULL ? obj_to_str(value) : "unknown Python error");
+  if (type != NULL) res = std::string(reinterpret_cast<PyTypeObject*>(type)->tp_name) + ": " + res;
+  Py_XDECREF(type);
+  Py_XDECREF(value);
+  Py_XDECREF(traceback);
+  return res;
+}
+
+/// A command of a batch, with its arguments converted.
+struct Call {
+  Command* command;
+  std::vector<Value> values;
+  bool threadSafe;
+  Value result;
+  std::string error;
+};
+
+/// \brief Find the command and convert its arguments.
+/// \return an empty string, or the reason why the command cannot be executed.
+std::string resolve(bp::object entry, Call& call) {
+  try {
+    if (bp::len(entry) != 3) return "expected a tuple (entity name, command name, arguments)";
+    const std::string entityName = bp::extract<std::string>(entry[0]), commandName = bp::extract<std::string>(entry[1]);
+    Entity* entity = NULL;
+    if (!PoolStorage::getInstance()->existEntity(entityName, entity)) return "no entity named " + entityName;
+    const Entity::CommandMap_t& commands = entity->getNewStyleCommandMap();
+    Entity::CommandMap_t::const_iterator command = commands.find(commandName);
+    if (command == commands.end()) return "entity " + entityName + " has no command " + commandName;
+    call.command = command->second;
+    call.threadSafe = threadSafeCommands().count(std::make_pair(entity->getClassName(), commandName)) > 0;
+
+    const Dispatch& cmd = dispatch(*call.command);
+    bp::tuple args(entry[2]);
+    const std::size_t nargs = std::size_t(bp::len(args));
+    if (nargs != cmd.converters.size())
+      return "wrong number of arguments for " + commandName + ": expected " + std::to_string(cmd.converters.size()) +
+             ", got " + std::to_string(nargs);
+    call.values.reserve(nargs);
+    for (std::size_t i = 0; i < nargs; ++i) call.values.push_back(cmd.converters[i](PyTuple_GET_ITEM(args.ptr(), i)));
+  } catch (const bp::error_already_set&) {
+    return fetchPythonError();
+  } catch (const std::exception& e) {
+    return e.what();
+  }
+  return std::string();
+}
+
+/// Python errors are only expected from commands executed with the GIL.
+void execute(Call& call) {
+  try {
+    if (!call.values.empty()) call.command->setParameterValues(call.values);
+    call.result = call.command->execute();
+  } catch (const bp::error_already_set&) {
+    call.error = fetchPythonError();
+  } catch (const std::exception& e) {
+    call.error = e.what();
+  }
+}
+}  // namespace
+
+bool isThreadSafe(Command& command) { return threadSafeCommands().count(commandKey(command)) > 0; }
+
+void setThreadSafe(Command& command, bool threadSafe) {
+  if (threadSafe)
+    threadSafeCommands().insert(commandKey(command));
+  else
+    threadSafeCommands().erase(commandKey(command));
+}
+
+bp::tuple executeBatch(bp::object entries) {
+  std::vector<Call> calls;
+  for (bp::stl_input_iterator<bp::object> it(entries), end; it != end; ++it) {
+    Call call = {NULL, std::vector<Value>(), false, Value(), std::string()};
+    call.error = resolve(*it, call);
+    calls.push_back(call);
+  }
+
+  for (std::size_t i = 0; i < calls.size();) {
+    if (calls[i].error.empty() && calls[i].threadSafe) {
+      AllowThreads allowThreads;
+      for (; i < calls.size() && (!calls[i].error.empty() || calls[i].threadSafe); ++i)
+        if (calls[i].error.empty()) execute(calls[i]);
+    } else {
+      if (calls[i].error.empty()) execute(calls[i]);
+      ++i;
+    }
+  }
+
+  bp::list results, errors;
+  for (std::size_t i = 0; i < calls.size(); ++i) {
+    if (calls[i].error.empty()) {
+      results.append(convert::fromValue(calls[i].result));
+    } else {
+      results.append(bp::object());
+      errors.append(bp::make_tuple(i, calls[i].error));
+    }
+  }
+  return bp::make_tuple(results, errors);
+}
+
 bp::object executeCmd(bp::tuple args, bp::dict) {
   Command& command = bp::template extract<Command&>(args[0]);
-  if (bp::len(args) != int(command.valueTypes().size() + 1))
-    // TODO Put expected and given number of args
-    throw std::out_of_range("Wrong number of arguments");
-  std::vector<Value> values;
-  values.reserve(command.valueTypes().size());
-  for (int i = 1; i < bp::len(args); ++i) values.push_back(convert::toValue(args[i], command.valueTypes()[i - 1]));
-  command.setParameterValues(values);
+  Dispatch& cmd = dispatch(command);
+  const std::size_t nargs = std::size_t(PyTuple_GET_SIZE(args.ptr()) - 1);
+  if (nargs != cmd.converters.size())
+    throw std::out_of_range("Wrong number of arguments: expected " + std::to_string(cmd.converters.size()) +
+                            ", got " + std::to_string(nargs));
+  // Commands without arguments keep their empty list of parameter values.
+  if (nargs > 0) {
+    for (std::size_t i = 0; i < nargs; ++i) cmd.values[i] = cmd.converters[i](PyTuple_GET_ITEM(args.ptr(), i + 1));
+    command.setParameterValues(cmd.values);
+  }
   return convert::fromValue(command.execute());
 }
 
@@ -62,6 +62,14 @@ void exposeSignalBase(const char* name) {
            "To which signal the signal is plugged")
 
       .def("recompute", &S_t::recompute, "Recompute the signal at given time")
+      .def("recomputeRange", &signalGroup::recomputeRange,
+           (bp::arg("t0"), bp::arg("t1"), bp::arg("step") = 1, bp::arg("others") = bp::object()),
+           "Recompute the signal at times t0, t0 + step, ... until t1 excluded and\n"
+           "return the values, stacked in a numpy array of shape (N,) + value shape.\n"
+           "The loop runs with the GIL released. If others is a list of signals,\n"
+           "they are recomputed at the same times, after the signal, and a tuple\n"
+           "(values, [values of each other signal]) is returned.\n"
+           "The signals must be of types whose values are arrays of double.")
 
       .def("__str__",
            +[](const S_t& s) -> std::string {
@@ -82,13 +90,18 @@ template <>
 auto exposeSignal<MatrixHomogeneous, time_type>(const std::string& name) {
   typedef Signal<MatrixHomogeneous, time_type> S_t;
   bp::class_<S_t, bp::bases<SignalBase<time_type> >, boost::noncopyable> obj(name.c_str(), bp::init<std::string>());
-  obj.add_property("value", +[](const S_t& signal) -> Matrix4 { return signal.accessCopy().matrix(); },
-                   +[](S_t& signal, const Matrix4& v) {
+  obj.add_property("value",
+                   bp::make_function(+[](const S_t& signal) -> const Matrix4& { return signal.accessCopy().matrix(); },
+                                     bp::return_value_policy<bp::copy_const_reference>()),
+                   +[](S_t& signal, bp::object v) {
                      // TODO it isn't hard to support pinocchio::SE3 type here.
                      // However, this adds a dependency to pinocchio.
-                     signal.setConstant(MatrixHomogeneous(v));
+                     if (!internal::setValueInPlace(signal, v))
+                       signal.setConstant(MatrixHomogeneous(bp::extract<Matrix4>(v)()));
                    },
-                   "the signal value.");
+                   "the signal value, as a 4x4 matrix.\n"
+                   "4x4 arrays are copied into it in place.");
+  internal::addViews<MatrixHomogeneous, time_type>(obj, std::true_type());
   return obj;
 }
 
@@ -114,49 +127,52 @@ void exposeSignals() {
 
 namespace signalBase {
 
-template <class T>
-SignalWrapper<T, int>* createSignalWrapperTpl(const char* name, bp::object o, std::string& error) {
-  typedef SignalWrapper<T, int> SignalWrapper_t;
-  if (!SignalWrapper_t::checkCallable(o, error)) {
-    return NULL;
-  }
-
-  SignalWrapper_t* obj = new SignalWrapper_t(name, o);
-  return obj;
-}
-
 PythonSignalContainer* getPythonSignalContainer() {
   Entity* obj = entity::create("PythonSignalContainer", "python_signals");
   return dynamic_cast<PythonSignalContainer*>(obj);
 }
 
-#define SIGNAL_WRAPPER_TYPE(IF, Enum, Type)                               \
-  IF(command::Value::typeName(command::Value::Enum).compare(type) == 0) { \
-    obj = createSignalWrapperTpl<Type>(name, object, error);              \
-  }
+void registerSignalWrapperTypes() {
+  typedef command::Value V;
+  SignalWrapperFactory::add(V::typeName(V::BOOL), &SignalWrapperFactory::create<bool>);
+  SignalWrapperFactory::add(V::typeName(V::UNSIGNED), &SignalWrapperFactory::create<unsigned>);
+  SignalWrapperFactory::add(V::typeName(V::INT), &SignalWrapperFactory::create<int>);
+  SignalWrapperFactory::add(V::typeName(V::FLOAT), &SignalWrapperFactory::create<float>);
+  SignalWrapperFactory::add(V::typeName(V::DOUBLE), &SignalWrapperFactory::create<double>);
+  SignalWrapperFactory::add(V::typeName(V::STRING), &SignalWrapperFactory::create<std::string>);
+  SignalWrapperFactory::add(V::typeName(V::VECTOR), &SignalWrapperFactory::create<Vector>);
+  SignalWrapperFactory::add(V::typeName(V::MATRIX), &SignalWrapperFactory::create<Matrix>);
+  SignalWrapperFactory::add(V::typeName(V::MATRIX4D), &SignalWrapperFactory::create<MatrixHomogeneous>);
+
+  // The fixed-size types of exposeSignals, by the name of their signal class.
+  SignalWrapperFactory::add("Vector3", &SignalWrapperFactory::create<Vector3>);
+  SignalWrapperFactory::add("Vector7", &SignalWrapperFactory::create<Vector7>);
+  SignalWrapperFactory::add("MatrixRotation", &SignalWrapperFactory::create<MatrixRotation>);
+  SignalWrapperFactory::add("MatrixHomogeneous", &SignalWrapperFactory::create<MatrixHomogeneous>);
+  SignalWrapperFactory::add("MatrixTwist", &SignalWrapperFactory::create<MatrixTwist>);
+  SignalWrapperFactory::add("Quaternion", &SignalWrapperFactory::create<Quaternion>);
+}
 
 /**
    \brief Create an instance of SignalWrapper
 */
-SignalBase<int>* createSignalWrapper(const char* name, const char* type, bp::object object) {
+SignalBase<int>* createSignalWrapper(const char* name, const char* type, bp::object object, bool outParameter,
+                                     bool asynchronous, bp::object user) {
   PythonSignalContainer* psc = getPythonSignalContainer();
   if (psc == NULL) return NULL;
 
-  SignalBase<int>* obj = NULL;
+  SignalWrapperFactory::Creator creator = SignalWrapperFactory::find(type);
+  if (creator == NULL) throw std::runtime_error("Type not understood");
   std::string error;
-  SIGNAL_WRAPPER_TYPE(if, BOOL, bool)
-  // SIGNAL_WRAPPER_TYPE(else if, UNSIGNED ,bool)
-  SIGNAL_WRAPPER_TYPE(else if, INT, int)
-  SIGNAL_WRAPPER_TYPE(else if, FLOAT, float)
-  SIGNAL_WRAPPER_TYPE(else if, DOUBLE, double)
-  // SIGNAL_WRAPPER_TYPE(else if, STRING   ,bool)
-  SIGNAL_WRAPPER_TYPE(else if, VECTOR, Vector)
-  // SIGNAL_WRAPPER_TYPE(else if, MATRIX   ,bool)
-  // SIGNAL_WRAPPER_TYPE(else if, MATRIX4D ,bool)
-  else {
-    error = "Type not understood";
+  int flags = (outParameter ? SignalWrapperFactory::OUT_PARAMETER : 0) |
+              (asynchronous ? SignalWrapperFactory::ASYNCHRONOUS : 0);
+  if (SignalWrapperFactory::isNativeFunction(object)) {
+    flags |= SignalWrapperFactory::NATIVE;
+    object = bp::make_tuple(object, user);
+  } else if (!user.is_none()) {
+    throw std::invalid_argument("user data is only given to native functions");
   }
-
+  SignalBase<int>* obj = creator(name, object, flags, error);
   if (obj == NULL) throw std::runtime_error(error);
   // Register signal into the python signal container
   psc->signalRegistration(*obj);
@@ -165,6 +181,11 @@ SignalBase<int>* createSignalWrapper(const char* name, const char* type, bp::obj
   return obj;
 }
 
+bp::list getSignalWrapperTypes() {
+  std::vector<std::string> types(SignalWrapperFactory::types());
+  return to_py_list(types.begin(), types.end());
+}
+
 }  // namespace signalBase
 }  // namespace python
 }  // namespace dynamicgraph
@@ -0,0 +1,141 @@
+// Copyright 2026, CNRS.
+
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include <dynamic-graph/linear-algebra.h>
+
+#include "dynamic-graph/python/dynamic-graph-py.hh"
+#include "dynamic-graph/python/signal-expression.hh"
+#include "dynamic-graph/python/value-access.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+namespace signalExpression {
+
+namespace {
+typedef Eigen::Vector3d Vector3;
+typedef Eigen::Matrix<double, 3, 3> MatrixRotation;
+typedef Eigen::Transform<double, 3, Eigen::Affine> MatrixHomogeneous;
+typedef Eigen::Matrix<double, 6, 6> MatrixTwist;
+typedef Eigen::Quaternion<double> Quaternion;
+
+/// Return a signal computing a @ b, or None if a and b are not of types A and B.
+typedef std::function<bp::object(bp::object a, bp::object b)> Product;
+
+template <class R, class A, class B>
+bp::object product(bp::object a, bp::object b) {
+  expression::Operand<A> x;
+  expression::Operand<B> y;
+  if (!expression::operand(a, x) || !expression::operand(b, y) || (x.signal == NULL && y.signal == NULL))
+    return bp::object();
+  return expression::binary<R, A, B, expression::MatMul>(x, y, a, b);
+}
+
+/// The matrix products, tried in this order.
+const std::vector<Product>& products() {
+  static const std::vector<Product> res = {
+      &product<Vector3, MatrixRotation, Vector3>,
+      &product<MatrixRotation, MatrixRotation, MatrixRotation>,
+      &product<Vector3, MatrixHomogeneous, Vector3>,
+      &product<MatrixHomogeneous, MatrixHomogeneous, MatrixHomogeneous>,
+      &product<Vector3, Quaternion, Vector3>,
+      &product<Quaternion, Quaternion, Quaternion>,
+      &product<MatrixTwist, MatrixTwist, MatrixTwist>,
+      &product<Vector, Matrix, Vector>,
+      &product<Matrix, Matrix, Matrix>,
+  };
+  return res;
+}
+
+bp::object matmul(bp::object a, bp::object b) {
+  for (const Product& p : products()) {
+    bp::object res = p(a, b);
+    if (!res.is_none()) return res;
+  }
+  return expression::notImplemented();
+}
+
+/// The function of a signal concatenating the values of signals and
+/// constants into a vector, each of them in row-major order.
+struct Concatenate {
+  struct Piece {
+    SignalBase<int>* signal;
+    const ValueAccess* access;
+    Vector constant;
+
+    Eigen::Index size() const { return (signal != NULL ? access->layout(*signal).size() : constant.size()); }
+  };
+  std::vector<Piece> pieces;
+
+  Vector& operator()(Vector& res, const int& t) const {
+    Eigen::Index size = 0;
+    for (const Piece& piece : pieces) {
+      if (piece.signal != NULL) piece.signal->recompute(t);
+      size += piece.size();
+    }
+    res.resize(size);
+    Eigen::Index offset = 0;
+    for (const Piece& piece : pieces) {
+      if (piece.signal != NULL) {
+        ArrayLayout layout = piece.access->layout(*piece.signal);
+        layout.copyTo(res.data() + offset);
+        offset += layout.size();
+      } else {
+        res.segment(offset, piece.constant.size()) = piece.constant;
+        offset += piece.constant.size();
+      }
+    }
+    return res;
+  }
+};
+
+bp::object concatenate(bp::object values) {
+  const bp::tuple items(values);
+  Concatenate function;
+  std::vector<SignalBase<int>*> signals;
+  std::string name;
+  for (bp::stl_input_iterator<bp::object> it(items), end; it != end; ++it) {
+    Concatenate::Piece piece = {NULL, NULL, Vector()};
+    bp::extract<SignalBase<int>&> signal(*it);
+    if (signal.check()) {
+      piece.signal = &signal();
+      piece.access = ValueAccess::find(*piece.signal);
+      if (piece.access == NULL)
+        throw std::invalid_argument("concatenate: the values of signal " + piece.signal->getName() +
+                                    " are not stored as arrays of double.");
+      signals.push_back(piece.signal);
+    } else {
+      bp::object array = bp::import("numpy").attr("ravel")(*it).attr("astype")("float64");
+      Buffer buffer(array.ptr());
+      if (!buffer.valid()) throw std::invalid_argument("concatenate: expected signals or arrays of double.");
+      piece.constant = buffer.map();
+    }
+    name += (name.empty() ? "" : ", ") + (piece.signal != NULL ? piece.signal->getName() : std::string("constant"));
+    function.pieces.push_back(piece);
+  }
+  return expression::makeSignal<Vector>("concatenate(" + name + ")", function, signals, items);
+}
+}  // namespace
+
+void expose() {
+  const char* classes[] = {"SignalVector3",           "SignalMatrixRotation", "SignalMatrixHomogeneous",
+                           "SignalQuaternion",        "SignalMatrixTwist",    "SignalVector",
+                           "SignalMatrix"};
+  for (const char* name : classes) {
+    bp::object cls = bp::scope().attr(name);
+    cls.attr("__matmul__") = bp::make_function(&matmul);
+    cls.attr("__rmatmul__") = bp::make_function(+[](bp::object self, bp::object other) { return matmul(other, self); });
+  }
+
+  bp::def("concatenate", &concatenate, bp::arg("values"),
+          "Return a signal computing the vector concatenating the values of signals\n"
+          "and constant arrays, each of them flattened in row-major order.\n"
+          "The signal is owned by the object returned, which keeps the values alive.");
+}
+
+}  // namespace signalExpression
+}  // namespace python
+}  // namespace dynamicgraph
@@ -0,0 +1,143 @@
+// Copyright 2026, CNRS.
+
+#include <memory>
+#include <stdexcept>
+
+#include "dynamic-graph/python/buffer.hh"
+#include "dynamic-graph/python/dynamic-graph-py.hh"
+#include "dynamic-graph/python/signal-group.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+namespace signalGroup {
+
+bp::tuple shape(const ArrayLayout& layout) {
+  switch (layout.ndim) {
+    case 0:
+      return bp::make_tuple();
+    case 1:
+      return bp::make_tuple(layout.shape[0]);
+    default:
+      return bp::make_tuple(layout.shape[0], layout.shape[1]);
+  }
+}
+
+namespace {
+SignalGroup* create(bp::object signals) { return new SignalGroup(to_std_vector<SignalBase<int>*>(signals)); }
+
+/// The group only holds pointers to the signals: their Python objects are
+/// kept alive as long as the group.
+void init(bp::object self, bp::object signals) {
+  bp::list list(signals);
+  bp::make_constructor(&create)(self, list);
+  self.attr("_signals") = list;
+}
+
+bp::list groupLayout(const SignalGroup& group) {
+  bp::list res;
+  for (const SignalGroup::Entry& entry : group.entries())
+    res.append(bp::make_tuple(entry.signal->getName(), entry.offset, shape(entry.layout)));
+  return res;
+}
+
+/// The memory of a one-dimensional contiguous array of the size of the group.
+double* groupData(const SignalGroup& group, const Buffer& buffer) {
+  if (!buffer.valid() || buffer.ndim() != 1 || std::size_t(buffer.size()) != group.size() ||
+      (buffer.size() > 1 && buffer.map().innerStride() != 1))
+    throw std::invalid_argument("SignalGroup: expected a contiguous one-dimensional array of " +
+                                std::to_string(group.size()) + " float64.");
+  return buffer.map().data();
+}
+
+bp::object readGroup(const SignalGroup& group, bp::object out) {
+  if (out.is_none()) out = bp::import("numpy").attr("empty")(group.size());
+  Buffer buffer(out.ptr(), true);
+  double* dst = groupData(group, buffer);
+  {
+    AllowThreads allowThreads;
+    group.read(dst);
+  }
+  return out;
+}
+
+/// The values of an entry in the rows of the array values.
+bp::object entryValues(const SignalGroup::Entry& entry, bp::object values) {
+  const Py_ssize_t begin = entry.offset, end = begin + entry.layout.size();
+  bp::object res = values[bp::make_tuple(bp::slice(), bp::slice(begin, end))];
+  bp::list shape;
+  shape.append(bp::len(values));
+  shape.extend(signalGroup::shape(entry.layout));
+  return res.attr("reshape")(bp::tuple(shape));
+}
+
+void writeGroup(const SignalGroup& group, bp::object in) {
+  Buffer buffer(in.ptr());
+  const double* src = groupData(group, buffer);
+  AllowThreads allowThreads;
+  group.write(src);
+}
+}  // namespace
+
+bp::object recomputeRange(SignalBase<int>& signal, int t0, int t1, int step, bp::object others) {
+  if (step <= 0) throw std::invalid_argument("recomputeRange: step must be positive.");
+  std::vector<SignalBase<int>*> signals(1, &signal);
+  bool withOthers = !others.is_none();
+  if (withOthers) {
+    std::vector<SignalBase<int>*> otherSignals(to_std_vector<SignalBase<int>*>(others));
+    signals.insert(signals.end(), otherSignals.begin(), otherSignals.end());
+  }
+  const Py_ssize_t nbTicks = (t1 > t0 ? (Py_ssize_t(t1) - t0 + step - 1) / step : 0);
+
+  // The shapes of the values are known once they are computed.
+  if (nbTicks > 0)
+    for (SignalBase<int>* s : signals) s->recompute(t0);
+  SignalGroup group(signals);
+  bp::object values = bp::import("numpy").attr("empty")(bp::make_tuple(nbTicks, group.size()));
+  if (nbTicks > 0) {
+    Buffer buffer(values.ptr(), true);
+    double* data = buffer.map().data();
+    group.read(data);
+    AllowThreads allowThreads;
+    for (Py_ssize_t i = 1; i < nbTicks; ++i) {
+      group.recompute(int(t0 + i * step));
+      group.read(data + i * group.size());
+    }
+  }
+
+  bp::object res = entryValues(group.entries()[0], values);
+  if (!withOthers) return res;
+  bp::list othersValues;
+  for (std::size_t i = 1; i < group.entries().size(); ++i)
+    othersValues.append(entryValues(group.entries()[i], values));
+  return bp::make_tuple(res, othersValues);
+}
+
+void expose() {
+  bp::class_<SignalGroup, boost::noncopyable>(
+      "SignalGroup",
+      "Copy the values of many signals from or into a single array.\n"
+      "The values are stored one after the other, each of them in row-major\n"
+      "order. The types of the signals and the shapes of the values are checked\n"
+      "once, when the group is built.",
+      bp::no_init)
+      .def("__init__", &init, bp::arg("signals"),
+           "Build a group from a list of signals. The Python signals are kept\n"
+           "alive by the group, but signals of entities must outlive it.")
+      .add_property("size", &SignalGroup::size, "the number of elements of the array")
+      .def("__len__", +[](const SignalGroup& group) { return group.entries().size(); })
+      .def("layout", &groupLayout, "Return a list of tuples (signal name, offset, shape), one for each signal.")
+      .def("read", &readGroup, (bp::arg("out") = bp::object()),
+           "Copy the current values of the signals into out, a contiguous\n"
+           "one-dimensional float64 array of the size of the group. The GIL is\n"
+           "released while copying. If out is None, a new array is returned.")
+      .def("write", &writeGroup, bp::arg("values"),
+           "Copy values, a contiguous one-dimensional float64 array of the size of\n"
+           "the group, into the values of the signals, in place. Signals which are\n"
+           "not constant are made constant, as with setConstant, and all of them\n"
+           "are marked as updated. The GIL is released while copying.");
+}
+
+}  // namespace signalGroup
+}  // namespace python
+}  // namespace dynamicgraph
@@ -0,0 +1,58 @@
+// Copyright 2026, CNRS.
+
+#include <stdexcept>
+
+#include "dynamic-graph/python/signal-group.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+namespace {
+// Only values of variable size need to be checked.
+void checkShape(const SignalGroup::Entry& entry, const ArrayLayout& layout) {
+  if (!entry.access->fixedSize() && !layout.sameShape(entry.layout))
+    throw std::runtime_error("SignalGroup: the shape of the value of signal " + entry.signal->getName() +
+                             " changed since the group was built.");
+}
+}  // namespace
+
+SignalGroup::SignalGroup(const std::vector<SignalBase<int>*>& signals) : size_(0) {
+  entries_.reserve(signals.size());
+  for (SignalBase<int>* signal : signals) {
+    if (signal == NULL) throw std::invalid_argument("SignalGroup: null signal.");
+    Entry entry;
+    entry.signal = signal;
+    entry.access = ValueAccess::find(*signal);
+    if (entry.access == NULL)
+      throw std::invalid_argument("SignalGroup: the values of signal " + signal->getName() +
+                                  " are not stored as arrays of double.");
+    entry.offset = size_;
+    entry.layout = entry.access->layout(*signal);
+    entry.layout.data = NULL;
+    size_ += entry.layout.size();
+    entries_.push_back(entry);
+  }
+}
+
+void SignalGroup::recompute(const int& t) const {
+  for (const Entry& entry : entries_) entry.signal->recompute(t);
+}
+
+void SignalGroup::read(double* data) const {
+  for (const Entry& entry : entries_) {
+    ArrayLayout layout = entry.access->layout(*entry.signal);
+    checkShape(entry, layout);
+    layout.copyTo(data + entry.offset);
+  }
+}
+
+void SignalGroup::write(const double* data) const {
+  for (const Entry& entry : entries_) {
+    ArrayLayout layout = entry.access->writableLayout(*entry.signal);
+    checkShape(entry, layout);
+    layout.copyFrom(data + entry.offset);
+  }
+}
+
+}  // namespace python
+}  // namespace dynamicgraph
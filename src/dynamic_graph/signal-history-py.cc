@@ -0,0 +1,98 @@
+// Copyright 2026, CNRS.
+
+#include <algorithm>
+
+#include "dynamic-graph/python/buffer.hh"
+#include "dynamic-graph/python/dynamic-graph-py.hh"
+#include "dynamic-graph/python/signal-history.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+namespace signalHistory {
+
+namespace {
+SignalHistory* create(SignalBase<int>& signal, std::size_t capacity) { return new SignalHistory(signal, capacity); }
+
+/// The history only holds a reference to the signal: its Python object is
+/// kept alive as long as the history.
+void init(bp::object self, bp::object signal, std::size_t capacity) {
+  bp::make_constructor(&create)(self, signal, capacity);
+  self.attr("_signal") = signal;
+}
+
+/// Reshape values, of shape (n, value size), into (n,) + the shape of the values.
+bp::object reshape(const SignalHistory& history, bp::object values, std::size_t n) {
+  bp::list shape;
+  shape.append(n);
+  shape.extend(signalGroup::shape(history.valueLayout()));
+  return values.attr("reshape")(bp::tuple(shape));
+}
+
+/// A read-only view of n values of the ring buffer from index first.
+bp::object segment(bp::object self, std::size_t first, std::size_t n) {
+  SignalHistory& history = bp::extract<SignalHistory&>(self);
+  const Py_ssize_t itemsize = sizeof(double), valueSize = history.valueSize();
+  ArrayLayout layout = {history.data() + first * valueSize,
+                        2,
+                        {Py_ssize_t(n), valueSize},
+                        {itemsize * valueSize, itemsize}};
+  bp::object values(bp::handle<>(arrayView(layout, false, self.ptr())));
+  return reshape(history, values, n);
+}
+
+bp::tuple segments(bp::object self) {
+  const SignalHistory& history = bp::extract<const SignalHistory&>(self);
+  const std::size_t first = history.begin(), n = std::min(history.size(), history.capacity() - first);
+  return bp::make_tuple(segment(self, first, n), segment(self, 0, history.size() - n));
+}
+
+bp::object values(const SignalHistory& history) {
+  bp::object res = bp::import("numpy").attr("empty")(bp::make_tuple(history.size(), history.valueSize()));
+  if (history.size() > 0) {
+    Buffer buffer(res.ptr(), true);
+    history.copyTo(buffer.map().data());
+  }
+  return reshape(history, res, history.size());
+}
+
+bp::list times(const SignalHistory& history) {
+  bp::list res;
+  for (std::size_t i = 0; i < history.size(); ++i)
+    res.append(history.times()[(history.begin() + i) % history.capacity()]);
+  return res;
+}
+}  // namespace
+
+void expose() {
+  bp::class_<SignalHistory, boost::noncopyable>(
+      "SignalHistory",
+      "Record the last values of a signal in a ring buffer allocated once.\n"
+      "Values are recorded by record(t) or each time the trigger signal is\n"
+      "recomputed, e.g. by a device. Read the history while it is not recorded.",
+      bp::no_init)
+      .def("__init__", &init, (bp::arg("signal"), "capacity"),
+           "Build the history of a signal, keeping at most capacity values.\n"
+           "The signal must be computed, to know the size of its values. A Python\n"
+           "signal is kept alive by the history, but a signal of an entity must\n"
+           "outlive it.")
+      .add_property("signal", bp::make_function(&SignalHistory::signal, bp::return_internal_reference<>()))
+      .add_property("trigger", bp::make_function(&SignalHistory::trigger, bp::return_internal_reference<>()),
+                    "the signal recording the value of the signal when recomputed")
+      .add_property("capacity", &SignalHistory::capacity)
+      .def("__len__", &SignalHistory::size)
+      .def("record", &SignalHistory::record, bp::arg("t"),
+           "Recompute the signal at time t and record its value, unless the last\n"
+           "recorded value is from time t.")
+      .def("clear", &SignalHistory::clear)
+      .def("segments", &segments,
+           "Return two read-only numpy arrays sharing the memory of the ring buffer,\n"
+           "the oldest values first, of shape (n,) + value shape. They are valid\n"
+           "until the next values are recorded.")
+      .def("values", &values, "Return a copy of the values, the oldest first, of shape (n,) + value shape.")
+      .def("times", &times, "Return the times of the values, the oldest first.");
+}
+
+}  // namespace signalHistory
+}  // namespace python
+}  // namespace dynamicgraph
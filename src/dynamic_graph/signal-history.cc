@@ -0,0 +1,76 @@
+// Copyright 2026, CNRS.
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+
+#include "dynamic-graph/python/signal-history.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+SignalHistory::SignalHistory(SignalBase<int>& signal, std::size_t capacity)
+    : signal_(signal),
+      access_(ValueAccess::find(signal)),
+      valueSize_(0),
+      capacity_(capacity),
+      head_(0),
+      size_(0),
+      trigger_(NULL) {
+  if (access_ == NULL)
+    throw std::invalid_argument("SignalHistory: the values of signal " + signal.getName() +
+                                " are not stored as arrays of double.");
+  if (capacity == 0) throw std::invalid_argument("SignalHistory: the capacity must be positive.");
+  valueLayout_ = access_->layout(signal);
+  valueLayout_.data = NULL;
+  valueSize_ = valueLayout_.size();
+  if (valueSize_ == 0)
+    throw std::invalid_argument("SignalHistory: the value of signal " + signal.getName() +
+                                " is empty. Compute it before building the history.");
+  data_.resize(capacity_ * valueSize_);
+  times_.resize(capacity_);
+  trigger_ = new SignalTimeDependent<int, int>(boost::bind(&SignalHistory::recordTrigger, this, _1, _2), sotNOSIGNAL,
+                                               "SignalHistory(" + signal.getName() + ")::trigger");
+  // Without dependencies, the trigger would otherwise never be updated after
+  // its first recomputation.
+  trigger_->setDependencyType(TimeDependency<int>::ALWAYS_READY);
+}
+
+namespace {
+int& ignoreTrigger(int& dummy, const int&) { return dummy; }
+}  // namespace
+
+SignalHistory::~SignalHistory() {
+  // The trigger is intentionally leaked: signals depending on it keep a
+  // pointer to it.
+  trigger_->clearDependencies();
+  trigger_->setFunction(&ignoreTrigger);
+}
+
+void SignalHistory::record(const int& t) {
+  if (size_ > 0 && times_[(head_ + capacity_ - 1) % capacity_] == t) return;
+  signal_.recompute(t);
+  ArrayLayout layout = access_->layout(signal_);
+  if (!access_->fixedSize() && !layout.sameShape(valueLayout_))
+    throw std::runtime_error("SignalHistory: the shape of the value of signal " + signal_.getName() +
+                             " changed since the history was built.");
+  layout.copyTo(&data_[head_ * valueSize_]);
+  times_[head_] = t;
+  head_ = (head_ + 1) % capacity_;
+  if (size_ < capacity_) ++size_;
+}
+
+void SignalHistory::copyTo(double* dst) const {
+  const std::size_t first = begin(), n = std::min(size_, capacity_ - first);
+  std::copy(data_.begin() + first * valueSize_, data_.begin() + (first + n) * valueSize_, dst);
+  std::copy(data_.begin(), data_.begin() + (size_ - n) * valueSize_, dst + n * valueSize_);
+}
+
+int& SignalHistory::recordTrigger(int& dummy, const int& t) {
+  record(t);
+  return dummy;
+}
+
+}  // namespace python
+}  // namespace dynamicgraph
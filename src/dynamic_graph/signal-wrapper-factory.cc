@@ -0,0 +1,113 @@
+// Copyright 2026, CNRS.
+
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "dynamic-graph/python/signal-wrapper.hh"
+
+namespace bp = boost::python;
+
+namespace dynamicgraph {
+namespace python {
+
+namespace {
+typedef std::unordered_map<std::string, SignalWrapperFactory::Creator> Registry_t;
+
+Registry_t& registry() {
+  static Registry_t res;
+  return res;
+}
+}  // namespace
+
+void SignalWrapperFactory::add(const std::string& type, Creator creator) { registry()[type] = creator; }
+
+SignalWrapperFactory::Creator SignalWrapperFactory::find(const std::string& type) {
+  Registry_t::const_iterator it = registry().find(type);
+  return (it == registry().end() ? NULL : it->second);
+}
+
+std::vector<std::string> SignalWrapperFactory::types() {
+  std::vector<std::string> res;
+  for (const auto& entry : registry()) res.push_back(entry.first);
+  std::sort(res.begin(), res.end());
+  return res;
+}
+
+namespace {
+std::mutex& asyncThreadsMutex() {
+  static std::mutex res;
+  return res;
+}
+
+std::set<AsyncSignalThread*>& asyncThreads() {
+  static std::set<AsyncSignalThread*> res;
+  return res;
+}
+}  // namespace
+
+AsyncSignalThread::AsyncSignalThread() {
+  std::lock_guard<std::mutex> lock(asyncThreadsMutex());
+  asyncThreads().insert(this);
+}
+
+AsyncSignalThread::~AsyncSignalThread() { unregister(); }
+
+void AsyncSignalThread::unregister() {
+#if PY_MAJOR_VERSION >= 3
+  // stopAll holds the mutex while joining threads which may wait for the GIL.
+  if (Py_IsInitialized() && PyGILState_Check()) {
+    AllowThreads allowThreads;
+    std::lock_guard<std::mutex> lock(asyncThreadsMutex());
+    asyncThreads().erase(this);
+    return;
+  }
+#endif
+  std::lock_guard<std::mutex> lock(asyncThreadsMutex());
+  asyncThreads().erase(this);
+}
+
+void AsyncSignalThread::stopAll() {
+  std::lock_guard<std::mutex> lock(asyncThreadsMutex());
+  for (AsyncSignalThread* thread : asyncThreads()) thread->stop();
+  asyncThreads().clear();
+}
+
+namespace {
+bool isInstance(bp::object o, bp::object type) { return PyObject_IsInstance(o.ptr(), type.ptr()) == 1; }
+
+bool isCffiObject(bp::object o) {
+  return bp::extract<std::string>(o.attr("__class__").attr("__module__"))() == "_cffi_backend";
+}
+}  // namespace
+
+bool SignalWrapperFactory::isNativeFunction(bp::object o) {
+  if (isCffiObject(o))
+    return bp::extract<std::string>(bp::import("cffi").attr("FFI")().attr("typeof")(o).attr("kind"))() == "function";
+  return isInstance(o, bp::import("ctypes").attr("_CFuncPtr"));
+}
+
+void* SignalWrapperFactory::address(bp::object o) {
+  if (o.is_none()) return NULL;
+  if (PyLong_Check(o.ptr())) return PyLong_AsVoidPtr(o.ptr());
+#if PY_MAJOR_VERSION < 3
+  if (PyInt_Check(o.ptr())) return PyLong_AsVoidPtr(o.ptr());
+#endif
+  if (isCffiObject(o)) {
+    bp::object value = bp::import("cffi").attr("FFI")().attr("cast")("uintptr_t", o);
+    return PyLong_AsVoidPtr(bp::object(bp::handle<>(PyNumber_Long(value.ptr()))).ptr());
+  }
+  bp::object ctypes = bp::import("ctypes");
+  if (isInstance(o, ctypes.attr("_CFuncPtr")) || isInstance(o, ctypes.attr("_Pointer")) ||
+      isInstance(o, ctypes.attr("c_void_p"))) {
+    bp::object value = ctypes.attr("cast")(o, bp::object(ctypes.attr("c_void_p"))).attr("value");
+    return (value.is_none() ? NULL : PyLong_AsVoidPtr(value.ptr()));
+  }
+  throw std::invalid_argument(bp::extract<std::string>(o.attr("__repr__")())() +
+                              " is not an address: expected a ctypes or cffi pointer, an integer or None");
+}
+
+}  // namespace python
+}  // namespace dynamicgraph
@@ -16,16 +16,6 @@ void PythonSignalContainer::rmSignal(const std::string& name) { Entity::signalDe
 
 DYNAMICGRAPH_FACTORY_ENTITY_PLUGIN(PythonSignalContainer, "PythonSignalContainer");
 
-template <class T, class Time>
-bool SignalWrapper<T, Time>::checkCallable(pyobject c, std::string& error) {
-  if (PyCallable_Check(c.ptr()) == 0) {
-    error = boost::python::extract<std::string>(c.attr("__str__")());
-    error += " is not callable";
-    return false;
-  }
-  return true;
-}
-
 template class SignalWrapper<bool, int>;
 template class SignalWrapper<int, int>;
 template class SignalWrapper<float, int>;
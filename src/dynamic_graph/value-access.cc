@@ -0,0 +1,36 @@
+// Copyright 2026, CNRS.
+
+#include <memory>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+#include "dynamic-graph/python/value-access.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+namespace {
+typedef std::vector<std::pair<std::type_index, std::unique_ptr<ValueAccess> > > Registry_t;
+
+Registry_t& registry() {
+  static Registry_t res;
+  return res;
+}
+}  // namespace
+
+void ValueAccess::add(const std::type_info& type, ValueAccess* access) {
+  std::unique_ptr<ValueAccess> owned(access);
+  for (const auto& entry : registry())
+    if (entry.first == std::type_index(type)) return;
+  registry().emplace_back(std::type_index(type), std::move(owned));
+}
+
+const ValueAccess* ValueAccess::find(const SignalBase<int>& signal) {
+  for (const auto& entry : registry())
+    if (entry.second->handles(signal)) return entry.second.get();
+  return NULL;
+}
+
+}  // namespace python
+}  // namespace dynamicgraph
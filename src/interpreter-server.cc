@@ -0,0 +1,259 @@
+// -*- mode: c++ -*-
+// Copyright 2026, CNRS.
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "dynamic-graph/python/interpreter-server.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+#ifdef MSG_NOSIGNAL
+static const int sendFlags = MSG_NOSIGNAL;
+#else
+static const int sendFlags = 0;
+#endif
+
+// Connections whose replies are not read are not read from either until the
+// pending output falls below this size.
+static const std::size_t maxPendingOutput = 1u << 26;
+
+static void setNonBlocking(int fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK); }
+
+static std::runtime_error socketError(const std::string& what) {
+  return std::runtime_error("InterpreterServer: " + what + ": " + std::strerror(errno));
+}
+
+static void appendFrame(std::string& output, char type, const std::string& payload) {
+  std::uint32_t size = static_cast<std::uint32_t>(payload.size());
+  char header[5] = {type, char(size >> 24), char(size >> 16), char(size >> 8), char(size)};
+  output.append(header, 5);
+  output.append(payload);
+}
+
+InterpreterServer::InterpreterServer(Interpreter& interpreter, const std::string& socketPath, int tcpPort)
+    : interpreter_(interpreter), socketPath_(socketPath), tcpPort_(-1), unixFd_(-1), tcpFd_(-1), stop_(false) {
+  wakeUp_[0] = wakeUp_[1] = -1;
+  try {
+    sockaddr_un unixAddress;
+    std::memset(&unixAddress, 0, sizeof(unixAddress));
+    if (socketPath.size() >= sizeof(unixAddress.sun_path))
+      throw std::runtime_error("InterpreterServer: socket path too long: " + socketPath);
+    unixAddress.sun_family = AF_UNIX;
+    std::strcpy(unixAddress.sun_path, socketPath.c_str());
+    // Only a socket left by a previous server is removed, before creating the
+    // socket so that closeSockets does not remove another file.
+    struct stat status;
+    if (lstat(socketPath.c_str(), &status) == 0) {
+      if (!S_ISSOCK(status.st_mode))
+        throw std::runtime_error("InterpreterServer: " + socketPath + " exists and is not a socket");
+      unlink(socketPath.c_str());
+    }
+    unixFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (unixFd_ < 0) throw socketError("socket");
+    if (bind(unixFd_, reinterpret_cast<sockaddr*>(&unixAddress), sizeof(unixAddress)) != 0 ||
+        listen(unixFd_, SOMAXCONN) != 0)
+      throw socketError("cannot listen on " + socketPath);
+    setNonBlocking(unixFd_);
+
+    if (tcpPort >= 0) {
+      sockaddr_in tcpAddress;
+      std::memset(&tcpAddress, 0, sizeof(tcpAddress));
+      tcpAddress.sin_family = AF_INET;
+      tcpAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      tcpAddress.sin_port = htons(static_cast<std::uint16_t>(tcpPort));
+      tcpFd_ = socket(AF_INET, SOCK_STREAM, 0);
+      if (tcpFd_ < 0) throw socketError("socket");
+      int one = 1;
+      setsockopt(tcpFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      socklen_t length = sizeof(tcpAddress);
+      if (bind(tcpFd_, reinterpret_cast<sockaddr*>(&tcpAddress), sizeof(tcpAddress)) != 0 ||
+          listen(tcpFd_, SOMAXCONN) != 0 ||
+          getsockname(tcpFd_, reinterpret_cast<sockaddr*>(&tcpAddress), &length) != 0)
+        throw socketError("cannot listen on port " + std::to_string(tcpPort));
+      tcpPort_ = ntohs(tcpAddress.sin_port);
+      setNonBlocking(tcpFd_);
+    }
+
+    if (pipe(wakeUp_) != 0) throw socketError("pipe");
+  } catch (...) {
+    closeSockets();
+    throw;
+  }
+  thread_ = std::thread(&InterpreterServer::run, this);
+}
+
+InterpreterServer::~InterpreterServer() {
+  stop_.store(true);
+  char byte = 0;
+  while (write(wakeUp_[1], &byte, 1) < 0 && errno == EINTR) {
+  }
+  thread_.join();
+  closeSockets();
+}
+
+void InterpreterServer::closeSockets() {
+  for (const Connection& connection : connections_) close(connection.fd);
+  connections_.clear();
+  if (unixFd_ >= 0) {
+    close(unixFd_);
+    unlink(socketPath_.c_str());
+  }
+  if (tcpFd_ >= 0) close(tcpFd_);
+  for (int fd : wakeUp_)
+    if (fd >= 0) close(fd);
+  unixFd_ = tcpFd_ = wakeUp_[0] = wakeUp_[1] = -1;
+}
+
+void InterpreterServer::run() {
+  std::vector<pollfd> fds;
+  std::vector<std::string> commands;
+  // Index in connections_ of the sender of each command.
+  std::vector<std::size_t> senders;
+  std::vector<CommandResult> results;
+  // Keep a Python thread state for this thread while it runs, so that the
+  // interpreter does not create one for each batch of commands.
+  PyGILState_STATE gilState = PyGILState_Ensure();
+  PyThreadState* threadState = PyEval_SaveThread();
+
+  while (!stop_.load()) {
+    fds.clear();
+    pollfd fd = {wakeUp_[0], POLLIN, 0};
+    fds.push_back(fd);
+    fd.fd = unixFd_;
+    fds.push_back(fd);
+    fd.fd = tcpFd_;
+    fds.push_back(fd);
+    for (const Connection& connection : connections_) {
+      fd.fd = connection.fd;
+      fd.events = 0;
+      std::size_t pending = connection.output.size() - connection.outputOffset;
+      if (!connection.eof && pending < maxPendingOutput) fd.events |= POLLIN;
+      if (pending > 0) fd.events |= POLLOUT;
+      fds.push_back(fd);
+    }
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) continue;
+      std::cerr << socketError("poll").what() << std::endl;
+      break;
+    }
+    if (fds[0].revents != 0) break;
+
+    // The connections accepted now are polled from the next iteration.
+    std::size_t nbConnections = connections_.size();
+    if (fds[1].revents & POLLIN) accept(unixFd_);
+    if (fds[2].revents & POLLIN) accept(tcpFd_);
+
+    commands.clear();
+    senders.clear();
+    for (std::size_t i = 0; i < nbConnections; ++i) {
+      if (fds[i + 3].revents & (POLLIN | POLLHUP | POLLERR)) {
+        receive(connections_[i], commands);
+        senders.resize(commands.size(), i);
+      }
+    }
+
+    if (!commands.empty()) {
+      interpreter_.python(commands, results);
+      for (std::size_t i = 0; i < results.size(); ++i) {
+        std::string& output = connections_[senders[i]].output;
+        if (!results[i].out.empty()) appendFrame(output, STDOUT, results[i].out);
+        if (!results[i].err.empty()) appendFrame(output, STDERR, results[i].err);
+        appendFrame(output, RESULT, results[i].result);
+      }
+    }
+
+    for (std::size_t i = 0; i < connections_.size();) {
+      Connection& connection = connections_[i];
+      if (!connection.closed) send(connection);
+      if (connection.closed || (connection.eof && connection.outputOffset == connection.output.size())) {
+        close(connection.fd);
+        connections_.erase(connections_.begin() + i);
+      } else {
+        ++i;
+      }
+    }
+  }
+  PyEval_RestoreThread(threadState);
+  PyGILState_Release(gilState);
+}
+
+void InterpreterServer::accept(int listenFd) {
+  while (true) {
+    int fd = ::accept(listenFd, NULL, NULL);
+    if (fd < 0) return;
+    setNonBlocking(fd);
+    int one = 1;
+    if (listenFd == tcpFd_) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    Connection connection = {fd, std::string(), std::string(), 0, false, false};
+    connections_.push_back(connection);
+  }
+}
+
+void InterpreterServer::receive(Connection& connection, std::vector<std::string>& commands) {
+  char buffer[65536];
+  while (true) {
+    ssize_t size = recv(connection.fd, buffer, sizeof(buffer), 0);
+    if (size > 0) {
+      connection.input.append(buffer, size);
+      if (std::size_t(size) < sizeof(buffer)) break;
+    } else if (size == 0) {
+      connection.eof = true;
+      break;
+    } else {
+      if (errno == EINTR) continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK) connection.closed = true;
+      break;
+    }
+  }
+
+  std::size_t offset = 0;
+  const std::string& input = connection.input;
+  while (input.size() - offset >= 4) {
+    const unsigned char* header = reinterpret_cast<const unsigned char*>(input.data() + offset);
+    std::uint32_t size = std::uint32_t(header[0]) << 24 | std::uint32_t(header[1]) << 16 |
+                         std::uint32_t(header[2]) << 8 | std::uint32_t(header[3]);
+    if (size > maxFrameSize) {
+      connection.closed = true;
+      break;
+    }
+    if (input.size() - offset - 4 < size) break;
+    commands.push_back(input.substr(offset + 4, size));
+    offset += 4 + size;
+  }
+  connection.input.erase(0, offset);
+}
+
+void InterpreterServer::send(Connection& connection) {
+  while (connection.outputOffset < connection.output.size()) {
+    ssize_t size = ::send(connection.fd, connection.output.data() + connection.outputOffset,
+                          connection.output.size() - connection.outputOffset, sendFlags);
+    if (size < 0) {
+      if (errno == EINTR) continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK) connection.closed = true;
+      return;
+    }
+    connection.outputOffset += size;
+  }
+  connection.output.clear();
+  connection.outputOffset = 0;
+}
+
+}  // namespace python
+}  // namespace dynamicgraph
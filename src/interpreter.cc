@@ -7,8 +7,23 @@
 #include <dlfcn.h>
 #endif
 
+#include <sys/stat.h>
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <sstream>
+
+#include <boost/python.hpp>
+#include <marshal.h>
+
 #include "dynamic-graph/debug.h"
+#include "dynamic-graph/python/buffer.hh"
+#include "dynamic-graph/python/convert-dg-to-py.hh"
 #include "dynamic-graph/python/interpreter.hh"
 
 std::ofstream dg_debugfile("/tmp/dynamic-graph-traces.txt", std::ios::trunc& std::ios::out);
@@ -16,24 +31,251 @@ std::ofstream dg_debugfile("/tmp/dynamic-graph-traces.txt", std::ios::trunc& std
 // Python initialization commands
 namespace dynamicgraph {
 namespace python {
-static const std::string pythonPrefix[8] = {"from __future__ import print_function\n",
-                                            "import traceback\n",
-                                            "class StdoutCatcher:\n"
-                                            "    def __init__(self):\n"
-                                            "        self.data = ''\n"
-                                            "    def write(self, stuff):\n"
-                                            "        self.data = self.data + stuff\n"
-                                            "    def fetch(self):\n"
-                                            "        s = self.data[:]\n"
-                                            "        self.data = ''\n"
-                                            "        return s\n",
-                                            "stdout_catcher = StdoutCatcher()\n",
-                                            "stderr_catcher = StdoutCatcher()\n",
-                                            "import sys\n",
-                                            "sys.stdout = stdout_catcher",
-                                            "sys.stderr = stderr_catcher"};
-
-bool HandleErr(std::string& err, PyObject* globals_, int PythonInputType) {
+namespace bp = boost::python;
+
+static const std::string pythonPrefix[3] = {"from __future__ import print_function\n", "import traceback\n",
+                                            "import sys\n"};
+
+/// A file-like object storing what is written into a C++ buffer.
+/// Instances replace sys.stdout and sys.stderr so that the outputs of the
+/// commands can be fetched without running Python code.
+struct OutputCatcher {
+  PyObject_HEAD
+  std::string* data;
+};
+
+static PyObject* OutputCatcher_new(PyTypeObject* type, PyObject*, PyObject*) {
+  OutputCatcher* self = reinterpret_cast<OutputCatcher*>(type->tp_alloc(type, 0));
+  if (self != NULL) self->data = new std::string;
+  return reinterpret_cast<PyObject*>(self);
+}
+
+static void OutputCatcher_dealloc(PyObject* self) {
+  delete reinterpret_cast<OutputCatcher*>(self)->data;
+  Py_TYPE(self)->tp_free(self);
+}
+
+static PyObject* OutputCatcher_write(PyObject* self, PyObject* args) {
+  std::string& data = *reinterpret_cast<OutputCatcher*>(self)->data;
+#if PY_MAJOR_VERSION >= 3
+  PyObject* str;
+  if (!PyArg_ParseTuple(args, "U:write", &str)) return NULL;
+  Py_ssize_t size;
+  const char* s = PyUnicode_AsUTF8AndSize(str, &size);
+  if (s == NULL) return NULL;
+  data.append(s, size);
+  return PyLong_FromSsize_t(PyUnicode_GetLength(str));
+#else
+  const char* s;
+  Py_ssize_t size;
+  if (!PyArg_ParseTuple(args, "s#:write", &s, &size)) return NULL;
+  data.append(s, size);
+  return PyInt_FromSsize_t(size);
+#endif
+}
+
+static PyObject* OutputCatcher_fetch(PyObject* self, PyObject*) {
+  std::string& data = *reinterpret_cast<OutputCatcher*>(self)->data;
+#if PY_MAJOR_VERSION >= 3
+  PyObject* res = PyUnicode_FromStringAndSize(data.data(), data.size());
+#else
+  PyObject* res = PyString_FromStringAndSize(data.data(), data.size());
+#endif
+  data.clear();
+  return res;
+}
+
+static PyObject* OutputCatcher_flush(PyObject*, PyObject*) { Py_RETURN_NONE; }
+
+static PyObject* OutputCatcher_isatty(PyObject*, PyObject*) { Py_RETURN_FALSE; }
+
+static PyMethodDef OutputCatcher_methods[] = {
+    {"write", OutputCatcher_write, METH_VARARGS, "Append a string to the buffer."},
+    {"fetch", OutputCatcher_fetch, METH_NOARGS, "Return and clear the content of the buffer."},
+    {"flush", OutputCatcher_flush, METH_NOARGS, "Do nothing."},
+    {"isatty", OutputCatcher_isatty, METH_NOARGS, "Return False."},
+    {NULL, NULL, 0, NULL}};
+
+static PyTypeObject* outputCatcherType() {
+  static PyTypeObject type = {PyVarObject_HEAD_INIT(NULL, 0)};
+  if (type.tp_name == NULL) {
+    type.tp_name = "dynamic_graph.OutputCatcher";
+    type.tp_basicsize = sizeof(OutputCatcher);
+    type.tp_flags = Py_TPFLAGS_DEFAULT;
+    type.tp_doc = "Store the strings written into it in a C++ buffer.";
+    type.tp_methods = OutputCatcher_methods;
+    type.tp_new = OutputCatcher_new;
+    type.tp_dealloc = OutputCatcher_dealloc;
+    if (PyType_Ready(&type) < 0) return NULL;
+  }
+  return &type;
+}
+
+/// Move the content of the catcher buffer into str.
+static void fetch(PyObject* catcher, std::string& str) {
+  str.clear();
+  str.swap(*reinterpret_cast<OutputCatcher*>(catcher)->data);
+}
+
+static const char* latencyStatsCapsuleName = "dynamic_graph.LatencyStats";
+
+static LatencyStats* latencyStatsOf(PyObject* capsule) {
+  return static_cast<LatencyStats*>(PyCapsule_GetPointer(capsule, latencyStatsCapsuleName));
+}
+
+static void deleteLatencyStats(PyObject* capsule) { delete latencyStatsOf(capsule); }
+
+static PyObject* histogramToDict(const LatencyHistogram& histogram) {
+  return Py_BuildValue("{s:K,s:d,s:d,s:d,s:d,s:d,s:d}", "count", static_cast<unsigned long long>(histogram.count()),
+                       "mean", histogram.mean(), "p50", histogram.quantile(.5), "p90", histogram.quantile(.9), "p99",
+                       histogram.quantile(.99), "p999", histogram.quantile(.999), "max", histogram.max());
+}
+
+// Functions of module interpreter_latency. self is the capsule of the statistics.
+static PyObject* latency_enable(PyObject* self, PyObject* args) {
+  int enable = 1;
+  if (!PyArg_ParseTuple(args, "|i:enable", &enable)) return NULL;
+  latencyStatsOf(self)->enabled.store(enable != 0);
+  Py_RETURN_NONE;
+}
+
+static PyObject* latency_enabled(PyObject* self, PyObject*) {
+  return PyBool_FromLong(latencyStatsOf(self)->enabled.load());
+}
+
+static PyObject* latency_reset(PyObject* self, PyObject*) {
+  latencyStatsOf(self)->clear();
+  Py_RETURN_NONE;
+}
+
+static PyObject* latency_phases(PyObject* self, PyObject*) {
+  const LatencyStats& stats = *latencyStatsOf(self);
+  PyObject* res = PyDict_New();
+  for (int i = 0; i < LatencyStats::NB_PHASES; ++i) {
+    PyObject* histogram = histogramToDict(stats.phases[i]);
+    PyDict_SetItemString(res, LatencyStats::phaseName(LatencyStats::Phase(i)), histogram);
+    Py_DECREF(histogram);
+  }
+  return res;
+}
+
+static PyObject* latency_commands(PyObject* self, PyObject*) {
+  const LatencyStats& stats = *latencyStatsOf(self);
+  PyObject* res = PyDict_New();
+  for (const auto& command : stats.commands) {
+    PyObject* histogram = histogramToDict(command.second);
+    PyDict_SetItemString(res, command.first.c_str(), histogram);
+    Py_DECREF(histogram);
+  }
+  return res;
+}
+
+static PyMethodDef latencyMethods[] = {
+    {"enable", latency_enable, METH_VARARGS, "enable(flag=True): enable or disable the recording of the latencies."},
+    {"enabled", latency_enabled, METH_NOARGS, "Whether the latencies are recorded."},
+    {"reset", latency_reset, METH_NOARGS, "Clear the recorded latencies."},
+    {"phases", latency_phases, METH_NOARGS,
+     "Return a dictionary of the statistics of each phase of the commands, durations in seconds."},
+    {"commands", latency_commands, METH_NOARGS,
+     "Return a dictionary of the statistics of the total duration of each command, in seconds."},
+    {NULL, NULL, 0, NULL}};
+
+/// Register module interpreter_latency, whose functions access the statistics
+/// held by the capsule.
+static void registerLatencyModule(PyObject* capsule) {
+  PyObject* module = PyModule_New("interpreter_latency");
+  for (PyMethodDef* def = latencyMethods; def->ml_name != NULL; ++def)
+    PyModule_AddObject(module, def->ml_name, PyCFunction_New(def, capsule));
+  PyDict_SetItemString(PyImport_GetModuleDict(), "interpreter_latency", module);
+  Py_DECREF(module);
+}
+
+/// Record the durations of the phases of a command into the latency
+/// statistics, if they are enabled when the command starts.
+class Interpreter::PhaseTimer {
+ public:
+  typedef std::chrono::steady_clock Clock_t;
+
+  explicit PhaseTimer(LatencyStats& stats) : stats_(stats), enabled_(stats.enabled.load(std::memory_order_relaxed)) {
+    start();
+  }
+
+  /// Start timing a command.
+  void start() {
+    if (enabled_) start_ = last_ = Clock_t::now();
+  }
+  /// Record the time elapsed since the end of the previous phase.
+  /// Must be called with the GIL held.
+  void lap(LatencyStats::Phase phase) {
+    if (!enabled_) return;
+    Clock_t::time_point now = Clock_t::now();
+    stats_.add(phase, std::chrono::duration_cast<LatencyHistogram::Duration_t>(now - last_));
+    last_ = now;
+  }
+  /// Record the total duration of the command. Must be called with the GIL held.
+  void stop(const std::string& command) {
+    if (!enabled_) return;
+    LatencyHistogram::Duration_t total = std::chrono::duration_cast<LatencyHistogram::Duration_t>(Clock_t::now() - start_);
+    stats_.add(LatencyStats::TOTAL, total);
+    stats_.addCommand(command, total);
+  }
+
+ private:
+  LatencyStats& stats_;
+  const bool enabled_;
+  Clock_t::time_point start_, last_;
+};
+
+// Evaluate a code object in the given dictionary of global variables.
+static PyObject* evalCode(PyObject* code, PyObject* globals) {
+#if PY_MAJOR_VERSION >= 3
+  return PyEval_EvalCode(code, globals, globals);
+#else
+  return PyEval_EvalCode(reinterpret_cast<PyCodeObject*>(code), globals, globals);
+#endif
+}
+
+// Whether the command is empty or a python comment.
+static bool isEmptyCommand(const std::string& command) {
+  std::string::size_type iFirstNonWhite = command.find_first_not_of(" \t");
+  return iFirstNonWhite == std::string::npos || command[iFirstNonWhite] == '#';
+}
+
+// Whether the word starts at position pos of text.
+static bool startsWithWord(const std::string& text, std::string::size_type pos, const std::string& word) {
+  const std::string::size_type end = pos + word.size();
+  return text.compare(pos, word.size(), word) == 0 &&
+         (text.size() == end || !(std::isalnum(static_cast<unsigned char>(text[end])) || text[end] == '_'));
+}
+
+// Whether a line may start a new top-level statement.
+static bool startsStatement(const std::string& line) {
+  if (line.empty() || std::isspace(static_cast<unsigned char>(line[0])) || line[0] == '#') return false;
+  // Clauses continuing a compound statement.
+  static const std::string clauses[] = {"else", "elif", "except", "finally"};
+  for (const std::string& clause : clauses)
+    if (startsWithWord(line, 0, clause)) return false;
+  return true;
+}
+
+// Whether code starts with a compound statement, which more indented lines or
+// clauses may continue even once it compiles. As match is a soft keyword,
+// statements starting with a variable named match are treated alike.
+static bool startsCompoundStatement(const std::string& code) {
+  std::string::size_type begin = code.find_first_not_of(" \t\n");
+  while (begin != std::string::npos && code[begin] == '#') {
+    begin = code.find('\n', begin);
+    if (begin != std::string::npos) begin = code.find_first_not_of(" \t\n", begin);
+  }
+  if (begin == std::string::npos) return false;
+  if (code[begin] == '@') return true;
+  static const std::string keywords[] = {"if", "for", "while", "try", "with", "def", "class", "async", "match"};
+  for (const std::string& keyword : keywords)
+    if (startsWithWord(code, begin, keyword)) return true;
+  return false;
+}
+
+bool HandleErr(std::string& err, PyObject* stderrCatcher, int PythonInputType) {
   dgDEBUGIN(15);
   err = "";
   bool lres = false;
@@ -41,9 +283,7 @@ bool HandleErr(std::string& err, PyObject* globals_, int PythonInputType) {
   if (PyErr_Occurred() != NULL) {
     bool is_syntax_error = PyErr_ExceptionMatches(PyExc_SyntaxError);
     PyErr_Print();
-    PyObject* stderr_obj = PyRun_String("stderr_catcher.fetch()", Py_eval_input, globals_, globals_);
-    err = obj_to_str(stderr_obj);
-    Py_DECREF(stderr_obj);
+    fetch(stderrCatcher, err);
 
     // Here if there is a syntax error and
     // and the interpreter input is set to Py_eval_input,
@@ -62,7 +302,12 @@ bool HandleErr(std::string& err, PyObject* globals_, int PythonInputType) {
   return lres;
 }
 
-Interpreter::Interpreter() {
+Interpreter::Interpreter()
+    : codeCacheCapacity_(256),
+      codeCacheHits_(0),
+      codeCacheMisses_(0),
+      bytecodeCacheHits_(0),
+      bytecodeCacheMisses_(0) {
   // load python dynamic library
   // this is silly, but required to be able to import dl module.
 #ifndef WIN32
@@ -78,13 +323,25 @@ Interpreter::Interpreter() {
   PyRun_SimpleString(pythonPrefix[0].c_str());
   PyRun_SimpleString(pythonPrefix[1].c_str());
   PyRun_SimpleString(pythonPrefix[2].c_str());
-  PyRun_SimpleString(pythonPrefix[3].c_str());
-  PyRun_SimpleString(pythonPrefix[4].c_str());
-  PyRun_SimpleString(pythonPrefix[5].c_str());
-  PyRun_SimpleString(pythonPrefix[6].c_str());
-  PyRun_SimpleString(pythonPrefix[7].c_str());
   PyRun_SimpleString("import linecache");
 
+  // Redirect the standard outputs into C++ buffers.
+  PyObject* catcherType = reinterpret_cast<PyObject*>(outputCatcherType());
+  stdoutCatcher_ = PyObject_CallObject(catcherType, NULL);
+  stderrCatcher_ = PyObject_CallObject(catcherType, NULL);
+  assert(stdoutCatcher_ && stderrCatcher_);
+  PyDict_SetItemString(globals_, "stdout_catcher", stdoutCatcher_);
+  PyDict_SetItemString(globals_, "stderr_catcher", stderrCatcher_);
+  PySys_SetObject(const_cast<char*>("stdout"), stdoutCatcher_);
+  PySys_SetObject(const_cast<char*>("stderr"), stderrCatcher_);
+
+  latencyStats_ = new LatencyStats;
+  latencyStatsCapsule_ = PyCapsule_New(latencyStats_, latencyStatsCapsuleName, deleteLatencyStats);
+  registerLatencyModule(latencyStatsCapsule_);
+
+  // Keep the initial variables, to restore them when resetting.
+  globalsSnapshot_ = PyDict_Copy(globals_);
+
   // Allow threads
   _pyState = PyEval_SaveThread();
 }
@@ -94,38 +351,42 @@ Interpreter::~Interpreter() {
 
   // Ideally, we should call Py_Finalize but this is not really supported by
   // Python.
-  // Instead, we merelly remove variables.
-  // Code was taken here: https://github.com/numpy/numpy/issues/8097#issuecomment-356683953
-  {
-    PyObject* poAttrList = PyObject_Dir(mainmod_);
-    PyObject* poAttrIter = PyObject_GetIter(poAttrList);
-    PyObject* poAttrName;
-
-    while ((poAttrName = PyIter_Next(poAttrIter)) != NULL) {
-      std::string oAttrName(obj_to_str(poAttrName));
+  // Instead, we merelly restore the variables to their initial state.
+  restoreGlobals();
+  Py_DECREF(globalsSnapshot_);
 
-      // Make sure we don't delete any private objects.
-      if (oAttrName.compare(0, 2, "__") != 0 || oAttrName.compare(oAttrName.size() - 2, 2, "__") != 0) {
-        PyObject* poAttr = PyObject_GetAttr(mainmod_, poAttrName);
-
-        // Make sure we don't delete any module objects.
-        if (poAttr && poAttr->ob_type != mainmod_->ob_type) PyObject_SetAttr(mainmod_, poAttrName, NULL);
-
-        Py_DECREF(poAttr);
-      }
-
-      Py_DECREF(poAttrName);
-    }
-
-    Py_DECREF(poAttrIter);
-    Py_DECREF(poAttrList);
-  }
+  shrinkCodeCache(0);
 
+  Py_DECREF(stdoutCatcher_);
+  Py_DECREF(stderrCatcher_);
+  // The statistics are deleted once module interpreter_latency is released.
+  Py_DECREF(latencyStatsCapsule_);
   Py_DECREF(mainmod_);
   Py_DECREF(globals_);
   // Py_Finalize();
 }
 
+void Interpreter::reset() {
+  EnsureGIL gil;
+  restoreGlobals();
+  std::string discarded;
+  fetch(stdoutCatcher_, discarded);
+  fetch(stderrCatcher_, discarded);
+}
+
+void Interpreter::restoreGlobals() {
+  // Variables that did not exist initially are removed before the initial
+  // ones are restored, so that __builtins__ remains available to the
+  // finalizers of the removed objects.
+  PyObject* keys = PyDict_Keys(globals_);
+  for (Py_ssize_t i = 0; i < PyList_GET_SIZE(keys); ++i) {
+    PyObject* key = PyList_GET_ITEM(keys, i);
+    if (!PyDict_Contains(globalsSnapshot_, key)) PyDict_DelItem(globals_, key);
+  }
+  Py_DECREF(keys);
+  PyDict_Update(globals_, globalsSnapshot_);
+}
+
 std::string Interpreter::python(const std::string& command) {
   std::string lerr(""), lout(""), lres("");
   python(command, lres, lout, lerr);
@@ -137,44 +398,15 @@ void Interpreter::python(const std::string& command, std::string& res, std::stri
   out = "";
   err = "";
 
-  // Check if the command is not a python comment or empty.
-  std::string::size_type iFirstNonWhite = command.find_first_not_of(" \t");
-  // Empty command
-  if (iFirstNonWhite == std::string::npos) return;
-  // Command is a comment. Ignore it.
-  if (command[iFirstNonWhite] == '#') return;
-
-  PyEval_RestoreThread(_pyState);
+  if (isEmptyCommand(command)) return;
 
-  std::cout << command.c_str() << std::endl;
-  PyObject* result = PyRun_String(command.c_str(), Py_eval_input, globals_, globals_);
-  // Check if the result is null.
-  if (result == NULL) {
-    // Test if this is a syntax error (due to the evaluation of an expression)
-    // else just output the problem.
-    if (!HandleErr(err, globals_, Py_eval_input)) {
-      // If this is a statement, re-parse the command.
-      result = PyRun_String(command.c_str(), Py_single_input, globals_, globals_);
-
-      // If there is still an error build the appropriate err string.
-      if (result == NULL) HandleErr(err, globals_, Py_single_input);
-      // If there is no error, make sure that the previous error message is erased.
-      else
-        err = "";
-    } else
-      dgDEBUG(15) << "Do not try a second time." << std::endl;
-  }
+  PhaseTimer timer(*latencyStats_);
+  EnsureGIL gil;
+  timer.lap(LatencyStats::GIL_WAIT);
 
-  PyObject* stdout_obj = 0;
-  stdout_obj = PyRun_String("stdout_catcher.fetch()", Py_eval_input, globals_, globals_);
-  out = obj_to_str(stdout_obj);
-  Py_DECREF(stdout_obj);
-  // Local display for the robot (in debug mode or for the logs)
-  if (out.size() != 0) std::cout << "Output:" << out << std::endl;
-  if (err.size() != 0) std::cout << "Error:" << err << std::endl;
+  PyObject* result = run(command, out, err, timer);
   // If python cannot build a string representation of result
   // then results is equal to NULL. This will trigger a SEGV
-  dgDEBUG(15) << "For command: " << command << std::endl;
   if (result != NULL) {
     res = obj_to_str(result);
     dgDEBUG(15) << "Result is: " << res << std::endl;
@@ -182,15 +414,206 @@ void Interpreter::python(const std::string& command, std::string& res, std::stri
   } else {
     dgDEBUG(15) << "Result is: empty" << std::endl;
   }
+  timer.lap(LatencyStats::CONVERT_RESULT);
+  timer.stop(command);
+}
+
+std::size_t Interpreter::python(const std::vector<std::string>& commands, std::vector<CommandResult>& results,
+                               bool stopOnError) {
+  results.clear();
+  results.resize(commands.size());
+
+  PhaseTimer timer(*latencyStats_);
+  EnsureGIL gil;
+  timer.lap(LatencyStats::GIL_WAIT);
+
+  std::size_t i = 0;
+  while (i < commands.size()) {
+    CommandResult& res = results[i];
+    const std::string& command = commands[i++];
+    if (isEmptyCommand(command)) continue;
+    timer.start();
+    PyObject* result = run(command, res.out, res.err, timer);
+    if (result != NULL) {
+      res.result = obj_to_str(result);
+      Py_DECREF(result);
+    }
+    timer.lap(LatencyStats::CONVERT_RESULT);
+    timer.stop(command);
+    if (result == NULL && stopOnError) break;
+  }
+
+  results.resize(i);
+  return i;
+}
+
+void Interpreter::python(const std::string& command, command::Value& res, std::string& out, std::string& err) {
+  res = command::Value();
+  out = "";
+  err = "";
+
+  if (isEmptyCommand(command)) return;
+
+  PhaseTimer timer(*latencyStats_);
+  EnsureGIL gil;
+  timer.lap(LatencyStats::GIL_WAIT);
+
+  PyObject* result = run(command, out, err, timer);
+  if (result != NULL) {
+    try {
+      // The handle steals the reference to result.
+      res = convert::toValue(bp::object(bp::handle<>(result)));
+    } catch (const bp::error_already_set&) {
+      HandleErr(err, stderrCatcher_, Py_single_input);
+    } catch (const std::exception& exc) {
+      err = exc.what();
+    }
+  }
+  timer.lap(LatencyStats::CONVERT_RESULT);
+  timer.stop(command);
+}
+
+bool Interpreter::python(const std::string& command, Eigen::Ref<Matrix> res, std::string& out, std::string& err) {
+  out = "";
+  err = "";
+
+  if (isEmptyCommand(command)) {
+    err = "empty command";
+    return false;
+  }
+
+  PhaseTimer timer(*latencyStats_);
+  EnsureGIL gil;
+  timer.lap(LatencyStats::GIL_WAIT);
+
+  bool success = false;
+  PyObject* result = run(command, out, err, timer);
+  if (result != NULL) {
+    if (PyFloat_Check(result) || PyLong_Check(result)) {
+      if (res.size() == 1) {
+        res(0, 0) = PyFloat_AsDouble(result);
+        success = true;
+      }
+    } else {
+      Buffer buffer(result);
+      if (buffer.valid() && buffer.rows() == res.rows() && buffer.cols() == res.cols()) {
+        res = buffer.map();
+        success = true;
+      } else if (buffer.valid() && buffer.ndim() == 1 && res.rows() == 1 && buffer.rows() == res.cols()) {
+        res = buffer.map().transpose();
+        success = true;
+      }
+    }
+    if (!success) {
+      std::ostringstream oss;
+      oss << "the result cannot be copied into a " << res.rows() << "x" << res.cols() << " matrix of double.";
+      err = oss.str();
+    }
+    Py_DECREF(result);
+  }
+  timer.lap(LatencyStats::CONVERT_RESULT);
+  timer.stop(command);
+  return success;
+}
+
+PyObject* Interpreter::run(const std::string& command, std::string& out, std::string& err, PhaseTimer& timer) {
+  int mode;
+  PyObject* result = NULL;
+  PyObject* code = compile(command, mode, err, timer);
+  if (code != NULL) {
+    result = evalCode(code, globals_);
+    Py_DECREF(code);
+    timer.lap(LatencyStats::EXECUTE);
+    // If there is an error build the appropriate err string.
+    if (result == NULL) HandleErr(err, stderrCatcher_, mode);
+  }
+
+  fetch(stdoutCatcher_, out);
+  // Only displayed in debug mode, as writing to the console takes time.
+  dgDEBUG(15) << "For command: " << command << std::endl;
   dgDEBUG(15) << "Out is: " << out << std::endl;
   dgDEBUG(15) << "Err is :" << err << std::endl;
+  timer.lap(LatencyStats::FETCH_OUTPUT);
+  return result;
+}
 
-  _pyState = PyEval_SaveThread();
+PyObject* Interpreter::globals() { return globals_; }
 
-  return;
+PyObject* Interpreter::compile(const std::string& command, int& mode, std::string& err, PhaseTimer& timer) {
+  std::unordered_map<std::string, CodeCache_t::iterator>::iterator it = codeCacheIndex_.find(command);
+  if (it != codeCacheIndex_.end()) {
+    ++codeCacheHits_;
+    // Mark the entry as the most recently used one.
+    codeCache_.splice(codeCache_.begin(), codeCache_, it->second);
+    mode = it->second->mode;
+    Py_INCREF(it->second->code);
+    timer.lap(LatencyStats::PARSE);
+    return it->second->code;
+  }
+  ++codeCacheMisses_;
+
+  // Try to compile the command as an expression.
+  mode = Py_eval_input;
+  PyObject* code = Py_CompileString(command.c_str(), "<string>", mode);
+  timer.lap(LatencyStats::PARSE);
+  // If this is a syntax error, it is maybe a statement instead of an
+  // expression. Therefore, re-parse the command.
+  if (code == NULL && PyErr_ExceptionMatches(PyExc_SyntaxError)) {
+    dgDEBUG(15) << "Detected a syntax error " << std::endl;
+    PyErr_Clear();
+    mode = Py_single_input;
+    code = Py_CompileString(command.c_str(), "<string>", mode);
+    timer.lap(LatencyStats::SINGLE_FALLBACK);
+  }
+  if (code == NULL) {
+    HandleErr(err, stderrCatcher_, mode);
+    return NULL;
+  }
+
+  if (codeCacheCapacity_ > 0) {
+    CompiledCommand entry = {command, code, mode};
+    Py_INCREF(code);
+    codeCache_.push_front(entry);
+    codeCacheIndex_[command] = codeCache_.begin();
+    shrinkCodeCache(codeCacheCapacity_);
+  }
+  return code;
 }
 
-PyObject* Interpreter::globals() { return globals_; }
+void Interpreter::shrinkCodeCache(std::size_t capacity) {
+  while (codeCache_.size() > capacity) {
+    codeCacheIndex_.erase(codeCache_.back().command);
+    Py_DECREF(codeCache_.back().code);
+    codeCache_.pop_back();
+  }
+}
+
+void Interpreter::setCodeCacheSize(std::size_t size) {
+  EnsureGIL gil;
+  codeCacheCapacity_ = size;
+  shrinkCodeCache(codeCacheCapacity_);
+}
+
+void Interpreter::clearCodeCache() {
+  EnsureGIL gil;
+  shrinkCodeCache(0);
+  codeCacheHits_ = 0;
+  codeCacheMisses_ = 0;
+}
+
+LatencyStats Interpreter::latencyStats() {
+  // The statistics are only modified with the GIL held.
+  PyGILState_STATE state = PyGILState_Ensure();
+  LatencyStats res(*latencyStats_);
+  PyGILState_Release(state);
+  return res;
+}
+
+void Interpreter::resetLatencyStats() {
+  PyGILState_STATE state = PyGILState_Ensure();
+  latencyStats_->clear();
+  PyGILState_Release(state);
+}
 
 void Interpreter::runPythonFile(std::string filename) {
   std::string err = "";
@@ -198,24 +621,112 @@ void Interpreter::runPythonFile(std::string filename) {
 }
 
 void Interpreter::runPythonFile(std::string filename, std::string& err) {
-  FILE* pFile = fopen(filename.c_str(), "r");
-  if (pFile == 0x0) {
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
     err = filename + " cannot be open";
     return;
   }
+  std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  file.close();
 
-  PyEval_RestoreThread(_pyState);
+  EnsureGIL gil;
 
   err = "";
-  PyObject* run = PyRun_File(pFile, filename.c_str(), Py_file_input, globals_, globals_);
+  PyObject* run = NULL;
+  PyObject* code = compileFile(filename, source);
+  if (code != NULL) {
+    run = evalCode(code, globals_);
+    Py_DECREF(code);
+  }
   if (run == NULL) {
-    HandleErr(err, globals_, Py_file_input);
+    HandleErr(err, stderrCatcher_, Py_file_input);
     std::cerr << err << std::endl;
   }
-  Py_DecRef(run);
+  Py_XDECREF(run);
+}
 
-  _pyState = PyEval_SaveThread();
-  fclose(pFile);
+PyObject* Interpreter::compileFile(const std::string& filename, const std::string& source) {
+  if (source.find('\0') != std::string::npos) {
+    PyErr_SetString(PyExc_ValueError, "source code string cannot contain null bytes");
+    return NULL;
+  }
+
+  struct stat status;
+  bool useCache = !bytecodeCacheDirectory_.empty() && stat(filename.c_str(), &status) == 0;
+  std::string cacheFile, header;
+  if (useCache) {
+    cacheFile = bytecodeCacheFile(filename);
+    // The key of the cached code object.
+    std::ostringstream key;
+    key << "dynamic-graph-python " << PyImport_GetMagicNumber() << ' ' << static_cast<long long>(status.st_mtime) << ' '
+        << static_cast<long long>(status.st_size) << ' ' << filename << '\n';
+    header = key.str();
+
+    PyObject* code = loadBytecode(cacheFile, header);
+    if (code != NULL) {
+      ++bytecodeCacheHits_;
+      return code;
+    }
+    ++bytecodeCacheMisses_;
+  }
+
+  PyObject* code = Py_CompileString(source.c_str(), filename.c_str(), Py_file_input);
+  if (code != NULL && useCache) saveBytecode(cacheFile, header, code);
+  return code;
+}
+
+PyObject* Interpreter::loadBytecode(const std::string& cacheFile, const std::string& header) {
+  std::ifstream file(cacheFile.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open()) return NULL;
+  std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  // The script changed or was cached by another version of Python.
+  if (data.compare(0, header.size(), header) != 0) return NULL;
+
+  PyObject* code =
+      PyMarshal_ReadObjectFromString(const_cast<char*>(data.data() + header.size()), data.size() - header.size());
+  if (code == NULL) {
+    PyErr_Clear();
+    return NULL;
+  }
+  if (!PyCode_Check(code)) {
+    Py_DECREF(code);
+    return NULL;
+  }
+  dgDEBUG(15) << "Loaded " << cacheFile << std::endl;
+  return code;
+}
+
+void Interpreter::saveBytecode(const std::string& cacheFile, const std::string& header, PyObject* code) {
+  PyObject* bytes = PyMarshal_WriteObjectToString(code, Py_MARSHAL_VERSION);
+  char* data;
+  Py_ssize_t size;
+  if (bytes == NULL || PyBytes_AsStringAndSize(bytes, &data, &size) != 0) {
+    PyErr_Clear();
+    Py_XDECREF(bytes);
+    return;
+  }
+  // Write into a temporary file first so that a concurrent reader never sees
+  // a partially written file.
+  std::string tmpFile = cacheFile + ".tmp";
+  std::ofstream file(tmpFile.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  file << header;
+  file.write(data, size);
+  file.close();
+  Py_DECREF(bytes);
+  if (!file || std::rename(tmpFile.c_str(), cacheFile.c_str()) != 0) {
+    dgDEBUG(15) << "Cannot write " << cacheFile << std::endl;
+    std::remove(tmpFile.c_str());
+  }
+}
+
+void Interpreter::setBytecodeCacheDirectory(const std::string& directory) { bytecodeCacheDirectory_ = directory; }
+
+std::string Interpreter::bytecodeCacheFile(const std::string& filename) const {
+  if (bytecodeCacheDirectory_.empty()) return std::string();
+  std::ostringstream oss;
+  oss << bytecodeCacheDirectory_ << '/' << filename.substr(filename.find_last_of("/\\") + 1) << '.' << std::hex
+      << std::hash<std::string>()(filename) << ".dgc";
+  return oss.str();
 }
 
 void Interpreter::runMain(void) {
@@ -231,22 +742,96 @@ void Interpreter::runMain(void) {
 }
 
 std::string Interpreter::processStream(std::istream& stream, std::ostream& os) {
-  char line[10000];
-  sprintf(line, "%s", "\n");
   std::string command;
-  std::streamsize maxSize = 10000;
-#if 0
-  while (line != std::string("")) {
-    stream.getline(line, maxSize, '\n');
-    command += std::string(line) + std::string("\n");
-  };
-#else
   os << "dg> ";
-  stream.getline(line, maxSize, ';');
-  command += std::string(line);
-#endif
+  std::getline(stream, command, ';');
   return command;
 }
 
+std::size_t Interpreter::runStream(std::istream& stream, std::ostream& os) {
+  // Maximal number of blocks executed under a single acquisition of the GIL.
+  static const std::size_t maxPendingBlocks = 1024;
+
+  std::vector<std::string> blocks;
+  std::string block, line, incomplete;
+  std::size_t nbErrors = 0;
+  bool eof = false;
+  while (!eof) {
+    // The GIL is not held while reading, as it may block.
+    eof = !std::getline(stream, line);
+    if (!eof) {
+      // An empty block ends the statement kept incomplete by runBlocks.
+      if (startsStatement(line) && (!block.empty() || !incomplete.empty())) {
+        blocks.push_back(block);
+        block.clear();
+      }
+      block += line;
+      block += '\n';
+    } else if (!block.empty()) {
+      blocks.push_back(block);
+    }
+    // Execute the pending blocks when no more input is immediately available,
+    // with the current block, so that a complete simple statement does not
+    // wait for the next one. runBlocks keeps it if it needs more lines.
+    const bool waiting = !eof && stream.rdbuf()->in_avail() <= 0;
+    if (waiting && !block.empty()) {
+      blocks.push_back(block);
+      block.clear();
+    }
+    if (!blocks.empty() && (eof || waiting || blocks.size() >= maxPendingBlocks)) {
+      nbErrors += runBlocks(blocks, incomplete, eof, waiting, os);
+      blocks.clear();
+    }
+  }
+  return nbErrors;
+}
+
+std::size_t Interpreter::runBlocks(const std::vector<std::string>& blocks, std::string& incomplete, bool last,
+                                   bool open, std::ostream& os) {
+  EnsureGIL gil;
+
+  PyObject* codeop = PyImport_ImportModule("codeop");
+  PyObject* compileCommand = (codeop == NULL ? NULL : PyObject_GetAttrString(codeop, "compile_command"));
+  Py_XDECREF(codeop);
+
+  std::size_t nbErrors = 0;
+  std::string out, err;
+  for (std::size_t i = 0; i < blocks.size(); ++i) {
+    incomplete += blocks[i];
+    PyObject* code = NULL;
+    if (compileCommand != NULL) {
+      code = PyObject_CallFunction(compileCommand, const_cast<char*>("sss"), incomplete.c_str(), "<stream>", "exec");
+      // The block needs more input.
+      if (code == Py_None) {
+        Py_DECREF(code);
+        if (!last || i + 1 < blocks.size()) continue;
+        // There is no more input: compile it to report the error.
+        code = Py_CompileString(incomplete.c_str(), "<stream>", Py_file_input);
+      } else if (code != NULL && open && i + 1 == blocks.size() && startsCompoundStatement(incomplete)) {
+        // The next lines may add to its body or clauses.
+        Py_DECREF(code);
+        continue;
+      }
+    }
+    incomplete.clear();
+
+    PyObject* result = NULL;
+    if (code != NULL) {
+      result = evalCode(code, globals_);
+      Py_DECREF(code);
+    }
+    err.clear();
+    if (result == NULL) {
+      HandleErr(err, stderrCatcher_, Py_file_input);
+      ++nbErrors;
+    }
+    Py_XDECREF(result);
+    fetch(stdoutCatcher_, out);
+    os << out << err;
+  }
+  Py_XDECREF(compileCommand);
+  return nbErrors;
+}
+
 }  // namespace python
 }  // namespace dynamicgraph
@@ -0,0 +1,104 @@
+// -*- mode: c++ -*-
+// Copyright 2026, CNRS.
+
+#include <algorithm>
+#include <cmath>
+
+#include "dynamic-graph/python/latency-stats.hh"
+
+namespace dynamicgraph {
+namespace python {
+
+namespace {
+// Durations below 4ns have one bucket each. Above, bucket 4 * (b - 1) + s,
+// where b is the index of the most significant bit, holds the durations in
+// [(4 + s) * 2^(b - 2), (5 + s) * 2^(b - 2)).
+int bucketIndex(std::uint64_t ns) {
+  if (ns < 4) return static_cast<int>(ns);
+  int b = 0;
+  while ((ns >> (b + 1)) != 0) ++b;
+  return 4 * (b - 1) + static_cast<int>((ns >> (b - 2)) & 3);
+}
+
+std::uint64_t bucketUpperBound(int i) {
+  if (i < 4) return static_cast<std::uint64_t>(i + 1);
+  return static_cast<std::uint64_t>(5 + i % 4) << (i / 4 - 1);
+}
+}  // namespace
+
+void LatencyHistogram::add(Duration_t duration) {
+  std::uint64_t ns = static_cast<std::uint64_t>(std::max(duration.count(), Duration_t::rep(0)));
+  ++buckets_[std::min(bucketIndex(ns), nbBuckets - 1)];
+  ++count_;
+  sum_ += ns;
+  max_ = std::max(max_, ns);
+}
+
+void LatencyHistogram::clear() {
+  std::fill(buckets_, buckets_ + nbBuckets, 0);
+  count_ = sum_ = max_ = 0;
+}
+
+double LatencyHistogram::mean() const { return (count_ == 0 ? 0. : 1e-9 * double(sum_) / double(count_)); }
+
+double LatencyHistogram::max() const { return 1e-9 * double(max_); }
+
+double LatencyHistogram::quantile(double q) const {
+  if (count_ == 0) return 0.;
+  std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(q * double(count_)));
+  std::uint64_t cumulated = 0;
+  for (int i = 0; i < nbBuckets; ++i) {
+    cumulated += buckets_[i];
+    // The last bucket also holds the longer durations.
+    if (cumulated >= rank && cumulated > 0 && i < nbBuckets - 1)
+      return 1e-9 * double(std::min(bucketUpperBound(i), max_));
+  }
+  return max();
+}
+
+const char* LatencyStats::phaseName(Phase phase) {
+  switch (phase) {
+    case GIL_WAIT:
+      return "gil_wait";
+    case PARSE:
+      return "parse";
+    case SINGLE_FALLBACK:
+      return "single_fallback";
+    case EXECUTE:
+      return "execute";
+    case FETCH_OUTPUT:
+      return "fetch_output";
+    case CONVERT_RESULT:
+      return "convert_result";
+    case TOTAL:
+      return "total";
+    default:
+      return "unknown";
+  }
+}
+
+LatencyStats::LatencyStats(const LatencyStats& other) : enabled(other.enabled.load()) { *this = other; }
+
+LatencyStats& LatencyStats::operator=(const LatencyStats& other) {
+  enabled = other.enabled.load();
+  std::copy(other.phases, other.phases + NB_PHASES, phases);
+  commands = other.commands;
+  return *this;
+}
+
+void LatencyStats::addCommand(const std::string& command, LatencyHistogram::Duration_t duration) {
+  std::unordered_map<std::string, LatencyHistogram>::iterator it = commands.find(command);
+  if (it == commands.end()) {
+    if (commands.size() >= maxCommands) return;
+    it = commands.insert(std::make_pair(command, LatencyHistogram())).first;
+  }
+  it->second.add(duration);
+}
+
+void LatencyStats::clear() {
+  for (int i = 0; i < NB_PHASES; ++i) phases[i].clear();
+  commands.clear();
+}
+
+}  // namespace python
+}  // namespace dynamicgraph
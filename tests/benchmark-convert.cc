@@ -0,0 +1,51 @@
+// Compare the conversions of numpy arrays and lists into command values, as
+// done by convert::toValue, with the former conversion through eigenpy.
+// Usage: benchmark-convert [number of conversions of 10000 elements]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <eigenpy/eigenpy.hpp>
+
+#include "dynamic-graph/python/convert-dg-to-py.hh"
+
+namespace bp = boost::python;
+
+using dynamicgraph::Vector;
+using dynamicgraph::command::Value;
+using dynamicgraph::python::convert::toValue;
+
+/// Nanoseconds per call of convert.
+template <typename Convert>
+double measure(Convert convert, long n) {
+  const auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < n; ++i) convert();
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / double(n);
+}
+
+int main(int argc, char** argv) {
+  long elements = 10000000;
+  if (argc > 1) elements = 10000 * atol(argv[1]);
+
+  Py_Initialize();
+  eigenpy::enableEigenPy();
+  try {
+    bp::object numpy = bp::import("numpy");
+    std::printf("%8s %14s %14s %14s\n", "size", "eigenpy (ns)", "array (ns)", "list (ns)");
+    for (long size : {3L, 10L, 100L, 1000L, 10000L}) {
+      bp::object array = numpy.attr("random").attr("rand")(size);
+      bp::object list = array.attr("tolist")();
+      const long n = std::max(1000L, elements / size);
+      const double eigenpy = measure([&] { Value(bp::extract<Vector>(array)()); }, n);
+      const double buffer = measure([&] { toValue(array, Value::VECTOR); }, n);
+      const double sequence = measure([&] { toValue(list, Value::VECTOR); }, n);
+      std::printf("%8ld %14.1f %14.1f %14.1f\n", size, eigenpy, buffer, sequence);
+    }
+  } catch (const bp::error_already_set&) {
+    PyErr_Print();
+    return 1;
+  }
+  return 0;
+}
@@ -9,6 +9,7 @@
 #include <boost/bind.hpp>
 
 #include <dynamic-graph/command-bind.h>
+#include <dynamic-graph/command.h>
 #include <dynamic-graph/entity.h>
 #include <dynamic-graph/exception-factory.h>
 #include <dynamic-graph/factory.h>
@@ -19,6 +20,18 @@
 
 namespace dynamicgraph {
 
+namespace {
+/// A command returning its argument, to test the conversions of the arguments.
+class Echo : public command::Command {
+ public:
+  Echo(Entity& entity, command::Value::Type type)
+      : command::Command(entity, std::vector<command::Value::Type>(1, type), "Return the argument.") {}
+
+ protected:
+  virtual command::Value doExecute() { return getParameterValues()[0]; }
+};
+}  // namespace
+
 CustomEntity::CustomEntity(const std::string n)
     : Entity(n),
       m_sigdSIN(NULL, "CustomEntity(" + name + ")::input(double)::in_double"),
@@ -31,6 +44,16 @@ CustomEntity::CustomEntity(const std::string n)
   using namespace dynamicgraph::command;
 
   this->addCommand("act", makeCommandVoid0(*this, &CustomEntity::act, docCommandVoid0("act on input signal")));
+  this->addCommand("echo_bool", new Echo(*this, Value::BOOL));
+  this->addCommand("echo_unsigned", new Echo(*this, Value::UNSIGNED));
+  this->addCommand("echo_int", new Echo(*this, Value::INT));
+  this->addCommand("echo_float", new Echo(*this, Value::FLOAT));
+  this->addCommand("echo_double", new Echo(*this, Value::DOUBLE));
+  this->addCommand("echo_string", new Echo(*this, Value::STRING));
+  this->addCommand("echo_vector", new Echo(*this, Value::VECTOR));
+  this->addCommand("echo_matrix", new Echo(*this, Value::MATRIX));
+  this->addCommand("echo_matrix4d", new Echo(*this, Value::MATRIX4D));
+  this->addCommand("echo_values", new Echo(*this, Value::VALUES));
 }
 
 void CustomEntity::addSignal() { signalRegistration(m_sigdSIN << m_sigdTimeDepSOUT); }
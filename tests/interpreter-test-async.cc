@@ -0,0 +1,58 @@
+// The purpose of this unit test is to check the AsyncInterpreter class
+#include <atomic>
+#include <iostream>
+
+#include "dynamic-graph/python/async-interpreter.hh"
+
+using dynamicgraph::python::AsyncInterpreter;
+using dynamicgraph::python::CommandResult;
+
+int main(int, char**) {
+  dynamicgraph::python::Interpreter interp;
+  bool res = true;
+  std::atomic<int> nbCallbacks(0);
+  {
+    AsyncInterpreter async(interp);
+    async.post("a = 1");
+    std::future<CommandResult> future = async.submit("a + 1");
+    async.submit("print(a + 2)", [&nbCallbacks](const CommandResult& result) {
+      if (result.out == "3\n") ++nbCallbacks;
+    });
+    std::future<CommandResult> error = async.submit("a +");
+
+    CommandResult result = future.get();
+    if (result.result != "2") {
+      std::cerr << "Wrong result: " << result.result << std::endl;
+      res = false;
+    }
+    if (error.get().err.empty()) {
+      std::cerr << "Syntax error not reported" << std::endl;
+      res = false;
+    }
+    // commands submitted before destruction are executed.
+    for (int i = 0; i < 100; ++i) async.post("a += 1");
+  }
+  if (nbCallbacks != 1) {
+    std::cerr << "The callback was not called" << std::endl;
+    res = false;
+  }
+  std::string result, out, err;
+  interp.python("a", result, out, err);
+  if (result != "101") {
+    std::cerr << "Pending commands were not executed: " << result << std::endl;
+    res = false;
+  }
+  {
+    // A signal wrapper takes the GIL to call its function.
+    AsyncInterpreter async(interp);
+    async.post("import dynamic_graph as dg");
+    async.post("sig = dg.create_signal_wrapper('async_wrapper', 'double', lambda t: 2. * t)");
+    async.post("sig.recompute(3)");
+    CommandResult wrapper = async.submit("sig.value").get();
+    if (wrapper.result != "6.0") {
+      std::cerr << "Wrong value of the signal wrapper: " << wrapper.result << wrapper.err << std::endl;
+      res = false;
+    }
+  }
+  return (res ? 0 : 1);
+}
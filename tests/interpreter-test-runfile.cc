@@ -1,12 +1,17 @@
 // The purpose of this unit test is to check the interpreter::runPythonFile method
+#include <sys/stat.h>
+
+#include <cstdio>
 #include <cstring>
 #include <iostream>
 
 #include "dynamic-graph/python/interpreter.hh"
 
-bool testFile(const std::string& filename, const std::string& expectedOutput, int numTest) {
+bool testFile(const std::string& filename, const std::string& expectedOutput, int numTest,
+              const std::string& cacheDirectory = "") {
   std::string err = "";
   dynamicgraph::python::Interpreter interp;
+  interp.setBytecodeCacheDirectory(cacheDirectory);
   for (int i = 0; i < numTest; ++i) {
     interp.runPythonFile(filename, err);
     if (err != expectedOutput) {
@@ -19,6 +24,28 @@ bool testFile(const std::string& filename, const std::string& expectedOutput, in
   return true;
 }
 
+/// Check that the code object of the script is written to the cache at the
+/// first run, and loaded from it at the next one.
+bool testBytecodeCache(const std::string& filename, const std::string& cacheDirectory) {
+  std::string err = "";
+  dynamicgraph::python::Interpreter interp;
+  interp.setBytecodeCacheDirectory(cacheDirectory);
+  const std::string cacheFile = interp.bytecodeCacheFile(filename);
+  std::remove(cacheFile.c_str());
+  interp.runPythonFile(filename, err);
+  struct stat status;
+  if (!err.empty() || stat(cacheFile.c_str(), &status) != 0 || interp.bytecodeCacheMisses() != 1) {
+    std::cerr << "The code object of " << filename << " was not cached in " << cacheFile << std::endl;
+    return false;
+  }
+  interp.runPythonFile(filename, err);
+  if (!err.empty() || interp.bytecodeCacheHits() != 1 || interp.bytecodeCacheMisses() != 1) {
+    std::cerr << "The code object of " << filename << " was not loaded from " << cacheFile << std::endl;
+    return false;
+  }
+  return true;
+}
+
 bool testInterpreterDestructor(const std::string& filename, const std::string& expectedOutput) {
   std::string err = "";
   {
@@ -70,6 +97,10 @@ int main(int argc, char** argv) {
                              "SyntaxError: invalid syntax\n"),
                  numTest) &&
         res;
+  // Same tests, with the code objects cached in the binary directory.
+  res = testFile(PATH "test_python-ok.py", "", 2, BINARY_PATH) && res;
+  res = testFile(PATH "unexistant_file.py", PATH "unexistant_file.py cannot be open", 2, BINARY_PATH) && res;
+  res = testBytecodeCache(PATH "test_python-ok.py", BINARY_PATH) && res;
   res = testInterpreterDestructor(PATH "test_python-restart_interpreter.py", "") && res;
   return (res ? 0 : 1);
 }
@@ -0,0 +1,134 @@
+// The purpose of this unit test is to check the InterpreterServer class
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "dynamic-graph/python/interpreter-server.hh"
+
+using dynamicgraph::python::InterpreterServer;
+
+static void sendCommand(int fd, const std::string& command) {
+  std::uint32_t size = htonl(static_cast<std::uint32_t>(command.size()));
+  std::string frame(reinterpret_cast<const char*>(&size), 4);
+  frame += command;
+  write(fd, frame.data(), frame.size());
+}
+
+static bool readAll(int fd, char* data, std::size_t size) {
+  while (size > 0) {
+    ssize_t n = read(fd, data, size);
+    if (n <= 0) return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+// Read the frames replying to a command.
+static bool readReply(int fd, std::string& result, std::string& out, std::string& err) {
+  result = out = err = "";
+  while (true) {
+    char header[5];
+    if (!readAll(fd, header, 5)) return false;
+    std::uint32_t size;
+    std::memcpy(&size, header + 1, 4);
+    std::string payload(ntohl(size), '\0');
+    if (!readAll(fd, &payload[0], payload.size())) return false;
+    switch (header[0]) {
+      case InterpreterServer::STDOUT:
+        out = payload;
+        break;
+      case InterpreterServer::STDERR:
+        err = payload;
+        break;
+      case InterpreterServer::RESULT:
+        result = payload;
+        return true;
+      default:
+        return false;
+    }
+  }
+}
+
+int main(int, char**) {
+  dynamicgraph::python::Interpreter interp;
+  bool res = true;
+  std::string result, out, err;
+  {
+    InterpreterServer server(interp, "interpreter-test-server.sock", 0);
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, server.socketPath().c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+      std::cerr << "Cannot connect to " << server.socketPath() << std::endl;
+      return 1;
+    }
+    // commands are pipelined.
+    sendCommand(fd, "a = 1");
+    for (int i = 0; i < 1000; ++i) sendCommand(fd, "a += 1");
+    sendCommand(fd, "print(a)");
+    sendCommand(fd, "a +");
+    sendCommand(fd, "a * 2");
+    for (int i = 0; i < 1001; ++i) readReply(fd, result, out, err);
+    if (!readReply(fd, result, out, err) || out != "1001\n") {
+      std::cerr << "Wrong output: " << out << std::endl;
+      res = false;
+    }
+    if (!readReply(fd, result, out, err) || err.empty()) {
+      std::cerr << "Syntax error not reported" << std::endl;
+      res = false;
+    }
+    if (!readReply(fd, result, out, err) || result != "2002") {
+      std::cerr << "Wrong result: " << result << std::endl;
+      res = false;
+    }
+    close(fd);
+
+    sockaddr_in tcpAddress;
+    std::memset(&tcpAddress, 0, sizeof(tcpAddress));
+    tcpAddress.sin_family = AF_INET;
+    tcpAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    tcpAddress.sin_port = htons(static_cast<std::uint16_t>(server.tcpPort()));
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&tcpAddress), sizeof(tcpAddress)) != 0) {
+      std::cerr << "Cannot connect to port " << server.tcpPort() << std::endl;
+      return 1;
+    }
+    sendCommand(fd, "a - 1");
+    // the replies are sent even if the client stops sending.
+    shutdown(fd, SHUT_WR);
+    if (!readReply(fd, result, out, err) || result != "1000") {
+      std::cerr << "Wrong result: " << result << std::endl;
+      res = false;
+    }
+    close(fd);
+  }
+  if (access("interpreter-test-server.sock", F_OK) == 0) {
+    std::cerr << "The socket file was not removed" << std::endl;
+    res = false;
+  }
+  // A file which is not a socket is not removed.
+  std::ofstream("interpreter-test-server.txt") << "not a socket";
+  try {
+    InterpreterServer server(interp, "interpreter-test-server.txt");
+    std::cerr << "A regular file was replaced by the socket" << std::endl;
+    res = false;
+  } catch (const std::runtime_error&) {
+  }
+  if (access("interpreter-test-server.txt", F_OK) != 0) {
+    std::cerr << "The regular file was removed" << std::endl;
+    res = false;
+  }
+  unlink("interpreter-test-server.txt");
+  return (res ? 0 : 1);
+}
@@ -1,7 +1,40 @@
 // The purpose of this unit test is to evaluate the memory consumption
 // when call the interpreter.
+#include <sstream>
+#include <streambuf>
+#include <vector>
+
 #include "dynamic-graph/python/interpreter.hh"
 
+using dynamicgraph::command::Value;
+
+/// A stream buffer giving one line at a time, as an interactive input, and
+/// recording the value of variable a each time the next line is requested.
+class LineBuffer : public std::streambuf {
+ public:
+  LineBuffer(dynamicgraph::python::Interpreter& interp, const std::vector<std::string>& lines)
+      : interp_(interp), lines_(lines), next_(0) {}
+
+  std::vector<std::string> values;
+
+ protected:
+  int_type underflow() {
+    std::string result, out, err;
+    interp_.python("a", result, out, err);
+    values.push_back(result);
+    if (next_ == lines_.size()) return traits_type::eof();
+    line_ = lines_[next_++];
+    setg(&line_[0], &line_[0], &line_[0] + line_.size());
+    return traits_type::to_int_type(line_[0]);
+  }
+
+ private:
+  dynamicgraph::python::Interpreter& interp_;
+  std::vector<std::string> lines_;
+  std::size_t next_;
+  std::string line_;
+};
+
 int main(int argc, char** argv) {
   int numTest = 1;
   if (argc > 1) numTest = atoi(argv[1]);
@@ -23,5 +56,109 @@ int main(int argc, char** argv) {
     assert(out.length() == 0);
     assert(err.length() > 50);
   }
+
+  // repeated commands are compiled only once
+  interp.clearCodeCache();
+  interp.python("a = 1", result, out, err);
+  interp.python("a + 1", result, out, err);
+  interp.python("a = 1", result, out, err);
+  interp.python("a + 1", result, out, err);
+  assert(result == "2");
+  assert(interp.codeCacheMisses() == 2);
+  assert(interp.codeCacheHits() == 2);
+  // the least recently used command is evicted
+  interp.setCodeCacheSize(1);
+  interp.python("a + 1", result, out, err);
+  interp.python("a = 1", result, out, err);
+  assert(interp.codeCacheHits() == 3);
+  assert(interp.codeCacheMisses() == 3);
+
+  // typed results
+  Value value;
+  interp.python("a + 1", value, out, err);
+  assert(value.type() == Value::INT && value.intValue() == 2);
+  interp.python("[1.5, 'a']", value, out, err);
+  assert(value.type() == Value::VALUES && value.constValuesValue()[0].doubleValue() == 1.5);
+  interp.python("import array", result, out, err);
+  dynamicgraph::Vector vector(3);
+  bool success = interp.python("array.array('d', [1., 2., 3.])", vector, out, err);
+  assert(success && vector[2] == 3.);
+  success = interp.python("array.array('d', [1., 2.])", vector, out, err);
+  assert(!success && err.length() > 0);
+
+  // outputs are caught
+  interp.python("for i in range(1000): print(i)\n", result, out, err);
+  assert(out.compare(0, 4, "0\n1\n") == 0 && out.size() == 3890);
+  interp.python("import sys; _ = sys.stderr.write('error')", result, out, err);
+  assert(out.length() == 0);
+
+  // batch execution
+  std::vector<std::string> commands = {"b = 1", "b + 1", "b +", "b + 2"};
+  std::vector<dynamicgraph::python::CommandResult> results;
+  assert(interp.python(commands, results) == 4 && results.size() == 4);
+  assert(results[1].result == "2" && results[2].err.length() > 0 && results[3].result == "3");
+  assert(interp.python(commands, results, true) == 3 && results.size() == 3);
+
+  // stream of python code
+  std::istringstream stream(
+      "def f(x):\n"
+      "    y = x + 1\n"
+      "\n"
+      "    return y\n"
+      "if f(1) == 2:\n"
+      "    print('yes')\n"
+      "else:\n"
+      "    print('no')\n"
+      "l = [1,\n"
+      "2]\n"
+      "print(l x)\n"
+      "print(len(l))\n");
+  std::ostringstream os;
+  assert(interp.runStream(stream, os) == 1);
+  assert(os.str().compare(0, 4, "yes\n") == 0 && os.str().find("SyntaxError") != std::string::npos);
+  assert(os.str().compare(os.str().size() - 2, 2, "2\n") == 0);
+
+  // complete simple statements are executed before the next line is read,
+  // compound statements once the next statement starts
+  interp.python("a = 0", result, out, err);
+  LineBuffer lineBuffer(interp, {"a = 1\n", "l = [a,\n", "2]\n", "a = len(l) + 1\n", "def f():\n",
+                                 "    return 4\n", "\n", "a = f()\n"});
+  std::istream lineStream(&lineBuffer);
+  assert(interp.runStream(lineStream, os) == 0);
+  const std::vector<std::string>& values = lineBuffer.values;
+  assert(values.size() >= 9 && values[0] == "0" && values[1] == "1" && values[3] == "1" && values[4] == "3");
+  assert(values[7] == "3" && values[8] == "4");
+
+  // reset the global variables
+  interp.python("import re; __name__ = 'modified'", result, out, err);
+  interp.reset();
+  interp.python("re", result, out, err);
+  assert(err.find("NameError") != std::string::npos);
+  interp.python("__name__", result, out, err);
+  assert(result == "__main__");
+
+  // latency statistics
+  using dynamicgraph::python::LatencyStats;
+  assert(!interp.latencyStatsEnabled());
+  interp.python("a = 1", result, out, err);
+  assert(interp.latencyStats().phases[LatencyStats::TOTAL].count() == 0);
+  interp.enableLatencyStats();
+  interp.python("a = 1", result, out, err);
+  interp.python("a + 1", result, out, err);
+  interp.python("a + 1", result, out, err);
+  LatencyStats stats = interp.latencyStats();
+  assert(stats.phases[LatencyStats::TOTAL].count() == 3);
+  assert(stats.phases[LatencyStats::EXECUTE].count() == 3);
+  assert(stats.commands.size() == 2 && stats.commands["a + 1"].count() == 2);
+  assert(stats.commands["a + 1"].quantile(.99) <= stats.commands["a + 1"].max());
+  interp.python("import interpreter_latency", result, out, err);
+  interp.python("interpreter_latency.commands()['a + 1']['count']", result, out, err);
+  assert(result == "2");
+  interp.python("interpreter_latency.reset()", result, out, err);
+  assert(interp.latencyStats().commands.size() == 1);
+  interp.resetLatencyStats();
+  interp.enableLatencyStats(false);
+  interp.python("a + 1", result, out, err);
+  assert(interp.latencyStats().phases[LatencyStats::TOTAL].count() == 0);
   return 0;
 }
@@ -1,5 +1,12 @@
+import ctypes
+import gc
+import subprocess
+import sys
+import time
 import unittest
 
+import numpy as np
+
 import dynamic_graph as dg
 from custom_entity import CustomEntity
 
@@ -46,6 +53,474 @@ class BindingsTests(unittest.TestCase):
         dg.plug(ent_2.signal('out_double'), ent.signal('in_double'))
         ent.act()
 
+    def test_command_arguments(self):
+        """
+        test that commands check the number of arguments at each call
+        """
+        ent = CustomEntity('test_command_arguments')
+        ent_2 = CustomEntity('test_command_arguments_2')
+        dg.plug(ent_2.signal('out_double'), ent.signal('in_double'))
+        for _ in range(3):
+            ent.act()
+            with self.assertRaises(IndexError) as cm:
+                ent.act(1.)
+            self.assertEqual(str(cm.exception), 'Wrong number of arguments: expected 0, got 1')
+
+    def test_scalar_arguments(self):
+        """
+        test the conversions of the scalar arguments of commands
+        """
+        ent = CustomEntity('test_scalar_arguments')
+        self.assertIs(ent.echo_bool(True), True)
+        self.assertIs(ent.echo_bool(0), False)
+        with self.assertRaises(TypeError):
+            ent.echo_bool('true')
+
+        self.assertEqual(ent.echo_int(-2**31), -2**31)
+        self.assertEqual(ent.echo_int(2**31 - 1), 2**31 - 1)
+        with self.assertRaises(OverflowError):
+            ent.echo_int(2**31)
+        with self.assertRaises(TypeError):
+            ent.echo_int(1.5)
+        self.assertEqual(ent.echo_unsigned(2**32 - 1), 2**32 - 1)
+        with self.assertRaises(OverflowError):
+            ent.echo_unsigned(-1)
+        with self.assertRaises(OverflowError):
+            ent.echo_unsigned(2**32)
+
+        self.assertEqual(ent.echo_float(0.5), 0.5)
+        self.assertEqual(ent.echo_float(2), 2.)
+        self.assertEqual(ent.echo_double(2**1000), float(2**1000))
+        with self.assertRaises(OverflowError):
+            ent.echo_double(10**400)
+        with self.assertRaises(TypeError):
+            ent.echo_double('1.')
+
+        self.assertEqual(ent.echo_string('abc'), 'abc')
+        self.assertEqual(ent.echo_string('été'), 'été')
+        with self.assertRaises(TypeError):
+            ent.echo_string(3)
+
+    def test_array_arguments(self):
+        """
+        test the conversions of the vector, matrix and values arguments of commands
+        """
+        ent = CustomEntity('test_array_arguments')
+        np.testing.assert_array_equal(ent.echo_vector([1, 2., 3]), [1., 2., 3.])
+        np.testing.assert_array_equal(ent.echo_vector((1., 2.)), [1., 2.])
+        np.testing.assert_array_equal(ent.echo_vector(np.arange(6.)[::2]), [0., 2., 4.])
+        # Arrays of integers are converted by eigenpy.
+        np.testing.assert_array_equal(ent.echo_vector(np.array([1, 2, 3])), [1., 2., 3.])
+        with self.assertRaises(TypeError):
+            ent.echo_vector(['a'])
+
+        np.testing.assert_array_equal(ent.echo_matrix([[1, 2], [3, 4]]), [[1., 2.], [3., 4.]])
+        np.testing.assert_array_equal(ent.echo_matrix(((1., 2., 3.), )), [[1., 2., 3.]])
+        m = np.arange(12.).reshape(3, 4)
+        np.testing.assert_array_equal(ent.echo_matrix(m[:, ::2]), m[:, ::2])
+        np.testing.assert_array_equal(ent.echo_matrix(np.asfortranarray(m)), m)
+        np.testing.assert_array_equal(ent.echo_matrix(np.eye(2, dtype=int)), np.eye(2))
+        with self.assertRaises(TypeError):
+            ent.echo_matrix([[1., 2.], [3.]])
+
+        np.testing.assert_array_equal(ent.echo_matrix4d(np.eye(4)), np.eye(4))
+        np.testing.assert_array_equal(ent.echo_matrix4d(np.eye(4).tolist()), np.eye(4))
+        with self.assertRaises(TypeError):
+            ent.echo_matrix4d(np.eye(3))
+        with self.assertRaises(TypeError):
+            ent.echo_matrix4d(np.eye(3).tolist())
+
+        self.assertEqual(ent.echo_values([1, 2.5, 'a', True, None, [3]]), [1, 2.5, 'a', True, None, [3]])
+        self.assertIs(ent.echo_values((True, ))[0], True)
+        self.assertEqual(ent.echo_values([2**31, 2**32 - 1, 2**40, -2**40]), [2**31, 2**32 - 1, 2**40, -2**40])
+        with self.assertRaises(OverflowError):
+            ent.echo_values([10**400])
+        vector, matrix = ent.echo_values((np.array([1., 2.]), np.eye(2)))
+        np.testing.assert_array_equal(vector, [1., 2.])
+        np.testing.assert_array_equal(matrix, np.eye(2))
+        with self.assertRaises(ValueError):
+            ent.echo_values(3)
+        with self.assertRaises(ValueError):
+            ent.echo_values([object()])
+
+    def test_execute_batch(self):
+        """
+        test executing commands of several entities at once
+        """
+        ent = CustomEntity('test_execute_batch')
+        ent_2 = CustomEntity('test_execute_batch_2')
+        dg.plug(ent_2.signal('out_double'), ent.signal('in_double'))
+        results, errors = dg.execute_batch([
+            ('test_execute_batch', 'act', ()),
+            ('test_execute_batch_unknown', 'act', ()),
+            ('test_execute_batch', 'act', (1., )),
+            ('test_execute_batch_2', 'act', ()),
+        ])
+        self.assertEqual(results, [None] * 4)
+        self.assertEqual([index for index, _ in errors], [1, 2, 3])
+        self.assertIn('SIN ptr not set', errors[2][1])
+
+        self.assertFalse(ent.act.threadSafe)
+        ent.act.threadSafe = True
+        try:
+            # The flag is shared by the entities of the class.
+            self.assertTrue(ent_2.act.threadSafe)
+            results, errors = dg.execute_batch([('test_execute_batch', 'act', ())] * 3)
+            self.assertEqual(errors, [])
+        finally:
+            ent.act.threadSafe = False
+        self.assertFalse(CustomEntity('test_execute_batch_3').act.threadSafe)
+
+    def test_view(self):
+        """
+        test that views share the memory of the signal values
+        """
+        sig = dg.wrap.SignalVector('test_view')
+        sig.value = np.array([1., 2., 3.])
+        view = sig.view()
+        np.testing.assert_array_equal(view, [1., 2., 3.])
+        self.assertFalse(view.flags.writeable)
+        with self.assertRaises(ValueError):
+            view[0] = 4.
+
+        sig = dg.wrap.SignalMatrix('test_view_matrix')
+        sig.value = np.array([[1., 2., 3.], [4., 5., 6.]])
+        np.testing.assert_array_equal(sig.view(), sig.value)
+
+        sig = dg.wrap.SignalMatrixHomogeneous('test_view_homogeneous')
+        sig.value = np.eye(4)
+        np.testing.assert_array_equal(sig.view(), np.eye(4))
+
+    def test_buffer(self):
+        """
+        test the modification of signal values in place
+        """
+        sig = dg.wrap.SignalVector('test_buffer')
+        sig.value = np.zeros(3)
+        sig.buffer()[1] = 2.
+        np.testing.assert_array_equal(sig.value, [0., 2., 0.])
+        np.add(np.ones(3), np.ones(3), out=sig.buffer())
+        np.testing.assert_array_equal(sig.value, [2., 2., 2.])
+
+        # the value of a plugged signal is copied before being modified
+        ent = CustomEntity('test_buffer_entity')
+        ent_2 = CustomEntity('test_buffer_entity_2')
+        dg.plug(ent.signal('in_double'), ent_2.signal('in_double'))
+        ent.signal('in_double').value = 3.
+        ent_2.signal('in_double').buffer()[()] = 4.
+        self.assertEqual(ent.signal('in_double').value, 3.)
+        self.assertEqual(ent_2.signal('in_double').value, 4.)
+
+    def test_signal_group(self):
+        """
+        test reading many signals at once
+        """
+        vector = dg.wrap.SignalVector('test_group_vector')
+        vector.value = np.array([1., 2., 3.])
+        matrix = dg.wrap.SignalMatrix('test_group_matrix')
+        matrix.value = np.array([[4., 5.], [6., 7.]])
+        ent = CustomEntity('test_group_entity')
+        ent.signal('in_double').value = 8.
+
+        group = dg.SignalGroup([vector, matrix, ent.signal('in_double')])
+        self.assertEqual(group.size, 8)
+        self.assertEqual(group.layout(), [('test_group_vector', 0, (3, )), ('test_group_matrix', 3, (2, 2)),
+                                          (ent.signal('in_double').name, 7, ())])
+        np.testing.assert_array_equal(group.read(), [1., 2., 3., 4., 5., 6., 7., 8.])
+        out = np.zeros(8)
+        group.read(out)
+        np.testing.assert_array_equal(out, np.arange(1., 9.))
+        with self.assertRaises(ValueError):
+            group.read(np.zeros(7))
+
+        group.write(np.arange(8.))
+        np.testing.assert_array_equal(vector.value, [0., 1., 2.])
+        np.testing.assert_array_equal(matrix.value, [[3., 4.], [5., 6.]])
+        self.assertEqual(ent.signal('in_double').value, 7.)
+
+        vector.value = np.zeros(4)
+        with self.assertRaises(RuntimeError):
+            group.read()
+        with self.assertRaises(RuntimeError):
+            group.write(np.zeros(8))
+        with self.assertRaises(ValueError):
+            dg.SignalGroup([dg.wrap.SignalInt('test_group_int')])
+
+        # the group keeps its Python signals alive
+        temporary = dg.wrap.SignalVector('test_group_temporary')
+        temporary.value = np.array([1., 2.])
+        group = dg.SignalGroup([temporary])
+        del temporary
+        gc.collect()
+        np.testing.assert_array_equal(group.read(), [1., 2.])
+
+    def test_recompute_range(self):
+        """
+        test recomputing a signal over a range of times
+        """
+        ent = CustomEntity('test_range_entity')
+        ent.signal('in_double').value = 2.
+        vector = dg.wrap.SignalVector('test_range_vector')
+        vector.value = np.array([1., 2., 3.])
+
+        values = ent.signal('out_double').recomputeRange(0, 10, 3)
+        np.testing.assert_array_equal(values, [2., 2., 2., 2.])
+        self.assertEqual(ent.signal('out_double').time, 9)
+
+        values, others = ent.signal('out_double').recomputeRange(10, 15, others=[vector])
+        self.assertEqual(values.shape, (5, ))
+        self.assertEqual(len(others), 1)
+        np.testing.assert_array_equal(others[0], np.tile([1., 2., 3.], (5, 1)))
+
+        self.assertEqual(ent.signal('out_double').recomputeRange(5, 5).shape, (0, ))
+        with self.assertRaises(ValueError):
+            ent.signal('out_double').recomputeRange(0, 10, 0)
+        with self.assertRaises(ValueError):
+            ent.signal('out_double').recomputeRange(0, 10, others=[dg.wrap.SignalInt('test_range_int')])
+
+    def test_signal_history(self):
+        """
+        test recording the last values of a signal
+        """
+        ent = CustomEntity('test_history_entity')
+        ent.signal('in_double').value = 0.
+        ent.signal('out_double').recompute(0)
+        history = dg.SignalHistory(ent.signal('out_double'), 3)
+        self.assertEqual(history.capacity, 3)
+        self.assertEqual(len(history), 0)
+        for t in range(1, 6):
+            ent.signal('in_double').value = float(t)
+            history.record(t)
+        history.record(5)
+        self.assertEqual(len(history), 3)
+        self.assertEqual(history.times(), [3, 4, 5])
+        np.testing.assert_array_equal(history.values(), [3., 4., 5.])
+        first, second = history.segments()
+        np.testing.assert_array_equal(np.concatenate([first, second]), [3., 4., 5.])
+        self.assertFalse(first.flags.writeable)
+
+        vector = dg.wrap.SignalVector('test_history_vector')
+        vector.value = np.array([1., 2.])
+        history = dg.SignalHistory(vector, 4)
+        history.record(0)
+        vector.value = np.array([3., 4.])
+        history.trigger.recompute(1)
+        np.testing.assert_array_equal(history.values(), [[1., 2.], [3., 4.]])
+        # the trigger records a value each time it is recomputed at a new time
+        for t in range(2, 5):
+            vector.value = np.array([t, -t])
+            history.trigger.recompute(t)
+            self.assertEqual(len(history), min(t + 1, 4))
+        self.assertEqual(history.times(), [1, 2, 3, 4])
+        np.testing.assert_array_equal(history.values(), [[3., 4.], [2., -2.], [3., -3.], [4., -4.]])
+        history.clear()
+        self.assertEqual(history.values().shape, (0, 2))
+
+        # the history keeps its Python signal alive
+        history = dg.SignalHistory(vector, 2)
+        del vector
+        gc.collect()
+        history.record(2)
+        np.testing.assert_array_equal(history.values(), [[3., 4.]])
+
+        with self.assertRaises(ValueError):
+            dg.SignalHistory(dg.wrap.SignalInt('test_history_int'), 3)
+
+    def test_unplugged_signal_ptr_value(self):
+        """
+        test setting numpy values on an input signal which is not plugged
+        """
+        ent = CustomEntity('test_unplugged_signal_ptr_value')
+        sig = ent.signal('in_double')
+        sig.value = np.float64(2.5)
+        self.assertEqual(sig.value, 2.5)
+        sig.value = np.array(3.5)
+        self.assertEqual(sig.value, 3.5)
+
+    def test_fixed_size_value(self):
+        """
+        test setting values of fixed size in place
+        """
+        pose = dg.wrap.SignalMatrixHomogeneous('test_value_pose')
+        pose.value = np.eye(4)
+        view = pose.view()
+        m = np.arange(16.).reshape(4, 4)
+        m[3] = [0., 0., 0., 1.]
+        pose.value = m
+        np.testing.assert_array_equal(pose.value, m)
+        np.testing.assert_array_equal(view, m)
+        pose.value = pose.view().copy()
+        np.testing.assert_array_equal(pose.value, m)
+
+        rotation = dg.wrap.SignalMatrixRotation('test_value_rotation')
+        rotation.value = np.eye(3)
+        rotation.value = np.asfortranarray(np.arange(9.).reshape(3, 3))
+        np.testing.assert_array_equal(rotation.value, np.arange(9.).reshape(3, 3))
+        rotation.value = rotation.view().T
+        np.testing.assert_array_equal(rotation.value, np.arange(9.).reshape(3, 3).T)
+
+        quaternion = dg.wrap.SignalQuaternion('test_value_quaternion')
+        quaternion.value = np.array([0., 0., 0., 1.])
+        np.testing.assert_array_equal(quaternion.value.coeffs(), [0., 0., 0., 1.])
+
+    def test_signal_wrapper_types(self):
+        """
+        test creating signals computed by python functions
+        """
+        for name in ['bool', 'double', 'vector', 'matrixXd', 'matrix4d', 'Vector3', 'MatrixHomogeneous', 'Quaternion']:
+            self.assertIn(name, dg.signal_wrapper_types())
+
+        def pose(t):
+            m = np.eye(4)
+            m[0, 3] = t
+            return m
+
+        sig = dg.create_signal_wrapper('test_wrapper_pose', 'MatrixHomogeneous', pose)
+        sig.recompute(3)
+        np.testing.assert_array_equal(sig.value, pose(3))
+        sig = dg.create_signal_wrapper('test_wrapper_vector3', 'Vector3', lambda t: np.array([t, 0., 0.]))
+        sig.recompute(2)
+        np.testing.assert_array_equal(sig.value, [2., 0., 0.])
+
+        with self.assertRaises(RuntimeError):
+            dg.create_signal_wrapper('test_wrapper_unknown', 'unknown', lambda t: 0)
+        with self.assertRaises(RuntimeError):
+            dg.create_signal_wrapper('test_wrapper_not_callable', 'double', 1)
+
+    def test_signal_wrapper_out(self):
+        """
+        test signals computed in place by python functions
+        """
+        def pose(t, out):
+            out[:] = np.eye(4)
+            out[0, 3] = t
+
+        sig = dg.create_signal_wrapper('test_wrapper_out_pose', 'MatrixHomogeneous', pose, out=True)
+        sig.recompute(3)
+        self.assertEqual(sig.value[0, 3], 3.)
+
+        def vector(t, out):
+            if out.shape != (3, ):
+                return np.zeros(3)
+            out[:] = t
+
+        sig = dg.create_signal_wrapper('test_wrapper_out_vector', 'vector', vector, out=True)
+        sig.recompute(1)
+        np.testing.assert_array_equal(sig.value, np.zeros(3))
+        for t in range(2, 5):
+            sig.recompute(t)
+            np.testing.assert_array_equal(sig.value, [t, t, t])
+
+        with self.assertRaises(RuntimeError):
+            dg.create_signal_wrapper('test_wrapper_out_int', 'int', lambda t, out: None, out=True)
+
+    def test_async_signal_wrapper(self):
+        """
+        test signals computed by python functions in a dedicated thread
+        """
+        sig = dg.create_signal_wrapper('test_wrapper_async', 'double', lambda t: 2. * t, asynchronous=True)
+        self.assertFalse(sig.hasValue)
+        self.assertEqual(sig.valueAge, float('inf'))
+        for _ in range(500):
+            sig.recompute(3)
+            if sig.hasValue:
+                break
+            time.sleep(0.01)
+        self.assertTrue(sig.hasValue)
+        self.assertEqual(sig.valueTime, 3)
+        self.assertEqual(sig.value, 6.)
+        self.assertGreaterEqual(sig.valueAge, 0.)
+
+    def test_async_signal_wrapper_exit(self):
+        """
+        test that the interpreter exits while a value is computed in the thread
+        """
+        script = ("import time\n"
+                  "import dynamic_graph as dg\n"
+                  "def f(t):\n"
+                  "    time.sleep(0.1)\n"
+                  "    return 1.\n"
+                  "sig = dg.create_signal_wrapper('test_wrapper_async_exit', 'double', f, asynchronous=True)\n"
+                  "sig.recompute(1)\n"
+                  "time.sleep(0.02)\n")
+        self.assertEqual(subprocess.call([sys.executable, '-c', script], timeout=60), 0)
+
+    def test_native_signal_wrapper(self):
+        """
+        test signals computed by native functions
+        """
+        function_t = ctypes.CFUNCTYPE(None, ctypes.POINTER(ctypes.c_double), ctypes.c_int, ctypes.c_void_p)
+
+        def fill(out, t, user):
+            out[0] = t
+            out[1] = 2. * t
+            out[2] = ctypes.cast(user, ctypes.POINTER(ctypes.c_double))[0]
+
+        function = function_t(fill)
+        scale = ctypes.c_double(5.)
+        sig = dg.create_signal_wrapper('test_wrapper_native', 'Vector3', function, user=ctypes.pointer(scale))
+        sig.recompute(2)
+        np.testing.assert_array_equal(sig.value, [2., 4., 5.])
+
+        with self.assertRaises(RuntimeError):
+            dg.create_signal_wrapper('test_wrapper_native_vector', 'vector', function)
+        with self.assertRaises(ValueError):
+            dg.create_signal_wrapper('test_wrapper_native_user', 'Vector3', function, user='user')
+
+    def test_signal_expressions(self):
+        """
+        test signals computing arithmetic expressions of other signals
+        """
+        a = dg.wrap.SignalVector('test_expression_a')
+        b = dg.wrap.SignalVector('test_expression_b')
+        d = dg.wrap.SignalDouble('test_expression_d')
+        a.value = np.array([1., 2., 3., 4.])
+        b.value = np.array([10., 20., 30., 40.])
+        d.value = .5
+
+        expressions = [
+            (a + b, [11., 22., 33., 44.]),
+            (a - [1., 1., 1., 1.], [0., 1., 2., 3.]),
+            (np.ones(4) - a, [0., -1., -2., -3.]),
+            (2. * a, [2., 4., 6., 8.]),
+            (a * d, [.5, 1., 1.5, 2.]),
+            (-a, [-1., -2., -3., -4.]),
+            (a[1:3], [2., 3.]),
+            (a[::-1], [4., 3., 2., 1.]),
+            (a[-1], 4.),
+            (3. - d, 2.5),
+            (dg.concatenate([a[:2], [7.], d]), [1., 2., 7., .5]),
+        ]
+        for t, (sig, value) in enumerate(expressions, 1):
+            sig.recompute(t)
+            np.testing.assert_array_equal(sig.value, value)
+
+        rotation = dg.wrap.SignalMatrixRotation('test_expression_rotation')
+        rotation.value = np.array([[0., -1., 0.], [1., 0., 0.], [0., 0., 1.]])
+        sig = rotation @ [1., 2., 3.]
+        sig.recompute(1)
+        np.testing.assert_array_equal(sig.value, [-2., 1., 3.])
+        sig = rotation @ rotation
+        sig.recompute(1)
+        np.testing.assert_array_equal(sig.value, np.diag([-1., -1., 1.]))
+
+        position = dg.wrap.SignalVector3('test_expression_position')
+        with self.assertRaises(TypeError):
+            a + position
+        sig = a + b
+        b.value = np.zeros(3)
+        with self.assertRaises(RuntimeError):
+            sig.recompute(20)
+
+        # expression signals keep their operands alive
+        temporary = dg.wrap.SignalVector('test_expression_temporary')
+        temporary.value = np.array([1., 2.])
+        sig = temporary * 2.
+        del temporary
+        gc.collect()
+        sig.recompute(21)
+        np.testing.assert_array_equal(sig.value, [2., 4.])
+
 
 if __name__ == '__main__':
     unittest.main()